@@ -0,0 +1,102 @@
+/****************************************************************************
+ * Copyright (c) 2016, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ****************************************************************************
+ */
+
+#include "utest/arena.h"
+#include <stdlib.h>
+
+#if UTEST_HUGE_PAGES_AVAILABLE
+#include <sys/mman.h>
+
+// the huge page size of x86-64 and AArch64, transparent huge pages only cover whole huge pages
+static const size_t huge_page_size = 2 * 1024 * 1024;
+#endif
+
+using namespace utest::v1;
+
+Arena::Arena() :
+    block(NULL), capacity(0), used(0), mapping_size(0), is_huge(false)
+{}
+
+Arena::~Arena()
+{
+    release();
+}
+
+bool Arena::reserve(const size_t size, const bool huge_pages)
+{
+    release();
+    if (size == 0)
+        return true;
+
+#if UTEST_HUGE_PAGES_AVAILABLE
+    if (huge_pages) {
+        const size_t length = (size + huge_page_size - 1) / huge_page_size * huge_page_size;
+        // the reserved huge pages are often exhausted or not configured at all
+        void *memory = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        bool huge = (memory != MAP_FAILED);
+        if (!huge) {
+            memory = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (memory == MAP_FAILED)
+                return false;
+#ifdef MADV_HUGEPAGE
+            huge = (madvise(memory, length, MADV_HUGEPAGE) == 0);
+#endif
+        }
+        block = static_cast<uint8_t*>(memory);
+        capacity = length;
+        mapping_size = length;
+        is_huge = huge;
+        return true;
+    }
+#else
+    (void) huge_pages;
+#endif
+
+    block = static_cast<uint8_t*>(malloc(size));
+    if (block == NULL)
+        return false;
+    capacity = size;
+    return true;
+}
+
+void Arena::release()
+{
+#if UTEST_HUGE_PAGES_AVAILABLE
+    if (mapping_size) munmap(block, mapping_size);
+    else free(block);
+#else
+    free(block);
+#endif
+    block = NULL;
+    capacity = 0;
+    used = 0;
+    mapping_size = 0;
+    is_huge = false;
+}
+
+void *Arena::allocate(const size_t size, const size_t alignment)
+{
+    if (block == NULL)
+        return NULL;
+    const uintptr_t next = uintptr_t(block) + used;
+    const size_t padding = (alignment - (next & (alignment - 1))) & (alignment - 1);
+    if (padding > capacity - used || size > capacity - used - padding)
+        return NULL;
+    used += padding + size;
+    return block + used - size;
+}
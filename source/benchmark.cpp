@@ -0,0 +1,336 @@
+/****************************************************************************
+ * Copyright (c) 2016, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ****************************************************************************
+ */
+
+#include "utest/benchmark.h"
+#include "utest/shim.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace utest::v1;
+
+// limits the growth of the iterations between two calibration steps
+static const size_t max_calibration_growth = 100;
+static const size_t max_iterations = 1000000000ul;
+
+uint64_t Benchmark::measure(const case_benchmark_handler_t handler, const size_t iterations)
+{
+    const uint64_t start = utest_v1_get_time_ns();
+    handler(iterations);
+    return utest_v1_get_time_ns() - start;
+}
+
+size_t Benchmark::calibrate(const size_t iterations, const uint64_t elapsed_ns, const uint64_t target_ns)
+{
+    if (elapsed_ns >= target_ns || iterations >= max_iterations)
+        return 0;
+
+    // aim 20% above the target, since the first iterations are usually slower
+    uint64_t next = (elapsed_ns == 0) ? uint64_t(iterations) * max_calibration_growth :
+                                        (uint64_t(iterations) * target_ns * 6) / (elapsed_ns * 5);
+    if (next <= iterations) next = iterations + 1;
+    if (next > uint64_t(iterations) * max_calibration_growth) next = uint64_t(iterations) * max_calibration_growth;
+    if (next > max_iterations) next = max_iterations;
+    return size_t(next);
+}
+
+static void sort(double *values, const size_t count)
+{
+    // the number of samples is small, so insertion sort is fast enough
+    for (size_t ii = 1; ii < count; ii++) {
+        const double value = values[ii];
+        size_t jj = ii;
+        for (; jj > 0 && values[jj - 1] > value; jj--)
+            values[jj] = values[jj - 1];
+        values[jj] = value;
+    }
+}
+
+// nearest-rank percentile of sorted values
+static double percentile(const double *values, const size_t count, const size_t percent)
+{
+    size_t rank = (percent * count + 99) / 100;
+    if (rank == 0) rank = 1;
+    return values[rank - 1];
+}
+
+static double median(const double *values, const size_t count)
+{
+    if (count == 0) return 0;
+    return (count & 1) ? values[count / 2] : (values[count / 2 - 1] + values[count / 2]) / 2;
+}
+
+benchmark_result_t Benchmark::evaluate(double *sample_ns, const size_t count, const size_t iterations)
+{
+    benchmark_result_t result = {iterations, count, 0, 0, 0, 0, 0, 0, sample_ns};
+    if (count == 0)
+        return result;
+
+    sort(sample_ns, count);
+    double sum = 0;
+    for (size_t ii = 0; ii < count; ii++)
+        sum += sample_ns[ii];
+    result.mean_ns = sum / count;
+
+    double variance = 0;
+    for (size_t ii = 0; ii < count; ii++)
+        variance += (sample_ns[ii] - result.mean_ns) * (sample_ns[ii] - result.mean_ns);
+    if (count > 1) variance /= (count - 1);
+    result.stddev_ns = sqrt(variance);
+
+    result.min_ns = sample_ns[0];
+    result.median_ns = median(sample_ns, count);
+    result.p90_ns = percentile(sample_ns, count, 90);
+    result.p99_ns = percentile(sample_ns, count, 99);
+    return result;
+}
+
+double Benchmark::compare(const double *sample_ns, const size_t count, const double *baseline_ns, const size_t baseline_count)
+{
+    if (count == 0 || baseline_count == 0)
+        return 1;
+
+    // merge both sorted sets to rank the samples, tied values share the average of their ranks
+    double rank_sum = 0;
+    double tie_sum = 0;
+    size_t rank = 1;
+    for (size_t ii = 0, jj = 0; ii < count || jj < baseline_count; )
+    {
+        const double value = (ii < count && (jj >= baseline_count || sample_ns[ii] <= baseline_ns[jj])) ? sample_ns[ii] : baseline_ns[jj];
+        size_t ties = 0;
+        size_t sample_ties = 0;
+        for (; ii < count && sample_ns[ii] == value; ii++) sample_ties++;
+        for (ties = sample_ties; jj < baseline_count && baseline_ns[jj] == value; jj++) ties++;
+
+        rank_sum += sample_ties * (rank + (ties - 1) / 2.0);
+        tie_sum += double(ties) * ties * ties - ties;
+        rank += ties;
+    }
+
+    const double n1 = count;
+    const double n2 = baseline_count;
+    const double n = n1 + n2;
+    // the number of pairs in which the sample is slower than the baseline sample
+    const double u = rank_sum - n1 * (n1 + 1) / 2;
+    const double variance = n1 * n2 / 12 * ((n + 1) - tie_sum / (n * (n - 1)));
+    // all samples are equal
+    if (variance <= 0)
+        return 1;
+
+    const double z = (u - n1 * n2 / 2 - 0.5) / sqrt(variance);
+    return 0.5 * erfc(z / sqrt(2.0));
+}
+
+// --- COMPARISON ---
+BenchmarkComparison::BenchmarkComparison() :
+    blocks(0), random(1)
+{
+    iterations[0] = iterations[1] = 1;
+}
+
+void BenchmarkComparison::reset(const size_t baseline_iterations, const size_t candidate_iterations, const uint32_t seed)
+{
+    iterations[0] = baseline_iterations;
+    iterations[1] = candidate_iterations;
+    blocks = 0;
+    // xorshift must not be seeded with zero
+    random = seed ? seed : 1;
+}
+
+void BenchmarkComparison::measure(const case_benchmark_handler_t baseline_handler, const case_benchmark_handler_t candidate_handler)
+{
+    if (blocks >= UTEST_BENCHMARK_SAMPLES)
+        return;
+
+    random ^= random << 13;
+    random ^= random >> 17;
+    random ^= random << 5;
+    const case_benchmark_handler_t handlers[2] = {baseline_handler, candidate_handler};
+    const size_t first = random & 1;
+
+    sample_ns[first][blocks] = double(Benchmark::measure(handlers[first], iterations[first])) / iterations[first];
+    sample_ns[!first][blocks] = double(Benchmark::measure(handlers[!first], iterations[!first])) / iterations[!first];
+    blocks++;
+}
+
+size_t BenchmarkComparison::get_blocks() const
+{
+    return blocks;
+}
+
+benchmark_comparison_t BenchmarkComparison::evaluate()
+{
+    benchmark_comparison_t result = {blocks, 0, 0, 1, 1, 1};
+    if (blocks == 0)
+        return result;
+
+    // the ratio of the times is log-normal, so its confidence interval is computed from the mean of the logarithms
+    double log_ratio[UTEST_BENCHMARK_SAMPLES];
+    double sum = 0;
+    for (size_t ii = 0; ii < blocks; ii++) {
+        const double baseline = (sample_ns[0][ii] > 0) ? sample_ns[0][ii] : 1e-3;
+        const double candidate = (sample_ns[1][ii] > 0) ? sample_ns[1][ii] : 1e-3;
+        log_ratio[ii] = log(candidate / baseline);
+        sum += log_ratio[ii];
+    }
+    const double mean = sum / blocks;
+    double margin = 0;
+    if (blocks > 1) {
+        double variance = 0;
+        for (size_t ii = 0; ii < blocks; ii++)
+            variance += (log_ratio[ii] - mean) * (log_ratio[ii] - mean);
+        variance /= (blocks - 1);
+        // 97.5% quantile of the t-distribution, approximated from the normal quantile
+        const double z = 1.959964;
+        const double t = z + (z * z * z + z) / (4 * (blocks - 1));
+        margin = t * sqrt(variance / blocks);
+    }
+    result.ratio = exp(mean);
+    result.ratio_low = exp(mean - margin);
+    result.ratio_high = exp(mean + margin);
+
+    sort(sample_ns[0], blocks);
+    sort(sample_ns[1], blocks);
+    result.baseline_ns = median(sample_ns[0], blocks);
+    result.candidate_ns = median(sample_ns[1], blocks);
+    return result;
+}
+
+// --- BASELINE ---
+BenchmarkBaseline::BenchmarkBaseline() :
+    loaded(NULL), saved(NULL)
+{}
+
+BenchmarkBaseline::~BenchmarkBaseline()
+{
+    close();
+}
+
+bool BenchmarkBaseline::open(const char *load_path, const char *save_path)
+{
+    close();
+    if (load_path) {
+        FILE *file = fopen(load_path, "r");
+        if (file == NULL) return false;
+        size_t length = 0;
+        size_t size = 1024;
+        loaded = static_cast<char*>(malloc(size));
+        while (loaded) {
+            length += fread(loaded + length, 1, size - length - 1, file);
+            if (length < size - 1) break;
+            size *= 2;
+            char *grown = static_cast<char*>(realloc(loaded, size));
+            if (grown == NULL) free(loaded);
+            loaded = grown;
+        }
+        fclose(file);
+        if (loaded == NULL) return false;
+        loaded[length] = '\0';
+    }
+    if (save_path) {
+        saved = fopen(save_path, "w");
+        if (saved == NULL) return false;
+        fprintf(saved, "# utest benchmark baseline: description, tab, ns per iteration of every sample\n");
+        fflush(saved);
+    }
+    return true;
+}
+
+void BenchmarkBaseline::close()
+{
+    free(loaded);
+    loaded = NULL;
+    if (saved) fclose(saved);
+    saved = NULL;
+}
+
+const char *BenchmarkBaseline::find(const char *description) const
+{
+    const size_t length = strlen(description);
+    for (const char *line = loaded; line && *line; ) {
+        if (*line != '#' && strncmp(line, description, length) == 0 && line[length] == '\t')
+            return line + length + 1;
+        line = strchr(line, '\n');
+        if (line) line++;
+    }
+    return NULL;
+}
+
+// parses the next sample on the current line
+static bool parse_sample(const char *&cursor, double &value)
+{
+    while (*cursor == ' ' || *cursor == '\t') cursor++;
+    if (*cursor == '\n' || *cursor == '\0') return false;
+    char *end;
+    value = strtod(cursor, &end);
+    if (end == cursor) return false;
+    cursor = end;
+    return true;
+}
+
+size_t BenchmarkBaseline::load(const char *description, double *sample_ns, const size_t size) const
+{
+    const char *samples = find(description);
+    if (samples == NULL || size == 0)
+        return 0;
+
+    double value;
+    size_t total = 0;
+    for (const char *cursor = samples; parse_sample(cursor, value); )
+        total++;
+
+    // choose evenly spaced samples, so that the distribution is preserved
+    const size_t count = (total < size) ? total : size;
+    const char *cursor = samples;
+    size_t index = 0;
+    for (size_t ii = 0; ii < count; ii++) {
+        const size_t chosen = (ii * total) / count;
+        for (; index <= chosen; index++)
+            parse_sample(cursor, value);
+        sample_ns[ii] = value;
+    }
+    sort(sample_ns, count);
+    return count;
+}
+
+void BenchmarkBaseline::save(const char *description, const benchmark_result_t result)
+{
+    if (saved == NULL)
+        return;
+    fprintf(saved, "%s\t", description);
+    for (size_t ii = 0; ii < result.samples; ii++)
+        fprintf(saved, (ii ? " %.3f" : "%.3f"), result.sample_ns[ii]);
+    fprintf(saved, "\n");
+    // the test case may be executing in a forked process, which does not flush its buffers
+    fflush(saved);
+}
+
+bool BenchmarkBaseline::is_regression(const char *description, const benchmark_result_t result) const
+{
+    double baseline_ns[UTEST_BENCHMARK_SAMPLES];
+    const size_t count = load(description, baseline_ns, UTEST_BENCHMARK_SAMPLES);
+    if (count == 0)
+        return false;
+
+    // small but significant differences are tolerated
+    if (result.median_ns * 100 <= median(baseline_ns, count) * (100 + UTEST_BENCHMARK_TOLERANCE_PERCENT))
+        return false;
+
+    const double p_value = Benchmark::compare(result.sample_ns, result.samples, baseline_ns, count);
+    return (p_value * 1000 < (1000 - UTEST_BENCHMARK_CONFIDENCE_PERMILLE));
+}
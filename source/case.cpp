@@ -30,9 +30,14 @@ Case::Case(const char *description,
     handler(handler),
     control_handler(ignore_handler),
     repeat_count_handler(ignore_handler),
+    benchmark_handler(ignore_handler),
+    comparison_handler(ignore_handler),
     setup_handler(setup_handler),
     teardown_handler(teardown_handler),
-    failure_handler(failure_handler)
+    failure_handler(failure_handler),
+    attributes(CASE_ATTRIBUTE_NONE),
+    stack_budget(0),
+    watchdog_ms(0)
 {}
 
 Case::Case(const char *description,
@@ -43,9 +48,14 @@ Case::Case(const char *description,
     handler(handler),
     control_handler(ignore_handler),
     repeat_count_handler(ignore_handler),
+    benchmark_handler(ignore_handler),
+    comparison_handler(ignore_handler),
     setup_handler(default_handler),
     teardown_handler(teardown_handler),
-    failure_handler(failure_handler)
+    failure_handler(failure_handler),
+    attributes(CASE_ATTRIBUTE_NONE),
+    stack_budget(0),
+    watchdog_ms(0)
 {}
 
 Case::Case(const char *description,
@@ -55,9 +65,14 @@ Case::Case(const char *description,
     handler(handler),
     control_handler(ignore_handler),
     repeat_count_handler(ignore_handler),
+    benchmark_handler(ignore_handler),
+    comparison_handler(ignore_handler),
     setup_handler(default_handler),
     teardown_handler(default_handler),
-    failure_handler(failure_handler)
+    failure_handler(failure_handler),
+    attributes(CASE_ATTRIBUTE_NONE),
+    stack_budget(0),
+    watchdog_ms(0)
 {}
 
 // control handler
@@ -70,9 +85,14 @@ Case::Case(const char *description,
     handler(ignore_handler),
     control_handler(handler),
     repeat_count_handler(ignore_handler),
+    benchmark_handler(ignore_handler),
+    comparison_handler(ignore_handler),
     setup_handler(setup_handler),
     teardown_handler(teardown_handler),
-    failure_handler(failure_handler)
+    failure_handler(failure_handler),
+    attributes(CASE_ATTRIBUTE_NONE),
+    stack_budget(0),
+    watchdog_ms(0)
 {}
 
 Case::Case(const char *description,
@@ -83,9 +103,14 @@ Case::Case(const char *description,
     handler(ignore_handler),
     control_handler(handler),
     repeat_count_handler(ignore_handler),
+    benchmark_handler(ignore_handler),
+    comparison_handler(ignore_handler),
     setup_handler(default_handler),
     teardown_handler(teardown_handler),
-    failure_handler(failure_handler)
+    failure_handler(failure_handler),
+    attributes(CASE_ATTRIBUTE_NONE),
+    stack_budget(0),
+    watchdog_ms(0)
 {}
 
 Case::Case(const char *description,
@@ -95,9 +120,14 @@ Case::Case(const char *description,
     handler(ignore_handler),
     control_handler(handler),
     repeat_count_handler(ignore_handler),
+    benchmark_handler(ignore_handler),
+    comparison_handler(ignore_handler),
     setup_handler(default_handler),
     teardown_handler(default_handler),
-    failure_handler(failure_handler)
+    failure_handler(failure_handler),
+    attributes(CASE_ATTRIBUTE_NONE),
+    stack_budget(0),
+    watchdog_ms(0)
 {}
 
 // control flow handler
@@ -110,9 +140,14 @@ Case::Case(const char *description,
     handler(ignore_handler),
     control_handler(ignore_handler),
     repeat_count_handler(case_repeat_count_handler),
+    benchmark_handler(ignore_handler),
+    comparison_handler(ignore_handler),
     setup_handler(setup_handler),
     teardown_handler(teardown_handler),
-    failure_handler(failure_handler)
+    failure_handler(failure_handler),
+    attributes(CASE_ATTRIBUTE_NONE),
+    stack_budget(0),
+    watchdog_ms(0)
 {}
 
 Case::Case(const char *description,
@@ -122,9 +157,14 @@ Case::Case(const char *description,
     handler(ignore_handler),
     control_handler(ignore_handler),
     repeat_count_handler(case_repeat_count_handler),
+    benchmark_handler(ignore_handler),
+    comparison_handler(ignore_handler),
     setup_handler(default_handler),
     teardown_handler(default_handler),
-    failure_handler(failure_handler)
+    failure_handler(failure_handler),
+    attributes(CASE_ATTRIBUTE_NONE),
+    stack_budget(0),
+    watchdog_ms(0)
 {}
 
 Case::Case(const char *description,
@@ -135,9 +175,127 @@ Case::Case(const char *description,
     handler(ignore_handler),
     control_handler(ignore_handler),
     repeat_count_handler(case_repeat_count_handler),
+    benchmark_handler(ignore_handler),
+    comparison_handler(ignore_handler),
     setup_handler(default_handler),
     teardown_handler(teardown_handler),
-    failure_handler(failure_handler)
+    failure_handler(failure_handler),
+    attributes(CASE_ATTRIBUTE_NONE),
+    stack_budget(0),
+    watchdog_ms(0)
+{}
+
+// benchmark handler
+Case::Case(const char *description,
+           const case_setup_handler_t setup_handler,
+           const case_benchmark_handler_t case_benchmark_handler,
+           const case_teardown_handler_t teardown_handler,
+           const case_failure_handler_t failure_handler) :
+    description(description),
+    handler(ignore_handler),
+    control_handler(ignore_handler),
+    repeat_count_handler(ignore_handler),
+    benchmark_handler(case_benchmark_handler),
+    comparison_handler(ignore_handler),
+    setup_handler(setup_handler),
+    teardown_handler(teardown_handler),
+    failure_handler(failure_handler),
+    attributes(CASE_ATTRIBUTE_NONE),
+    stack_budget(0),
+    watchdog_ms(0)
+{}
+
+Case::Case(const char *description,
+           const case_benchmark_handler_t case_benchmark_handler,
+           const case_failure_handler_t failure_handler) :
+    description(description),
+    handler(ignore_handler),
+    control_handler(ignore_handler),
+    repeat_count_handler(ignore_handler),
+    benchmark_handler(case_benchmark_handler),
+    comparison_handler(ignore_handler),
+    setup_handler(default_handler),
+    teardown_handler(default_handler),
+    failure_handler(failure_handler),
+    attributes(CASE_ATTRIBUTE_NONE),
+    stack_budget(0),
+    watchdog_ms(0)
+{}
+
+Case::Case(const char *description,
+           const case_benchmark_handler_t case_benchmark_handler,
+           const case_teardown_handler_t teardown_handler,
+           const case_failure_handler_t failure_handler) :
+    description(description),
+    handler(ignore_handler),
+    control_handler(ignore_handler),
+    repeat_count_handler(ignore_handler),
+    benchmark_handler(case_benchmark_handler),
+    comparison_handler(ignore_handler),
+    setup_handler(default_handler),
+    teardown_handler(teardown_handler),
+    failure_handler(failure_handler),
+    attributes(CASE_ATTRIBUTE_NONE),
+    stack_budget(0),
+    watchdog_ms(0)
+{}
+
+// paired benchmark handlers
+Case::Case(const char *description,
+           const case_setup_handler_t setup_handler,
+           const case_benchmark_handler_t baseline_handler,
+           const case_benchmark_handler_t candidate_handler,
+           const case_teardown_handler_t teardown_handler,
+           const case_failure_handler_t failure_handler) :
+    description(description),
+    handler(ignore_handler),
+    control_handler(ignore_handler),
+    repeat_count_handler(ignore_handler),
+    benchmark_handler(baseline_handler),
+    comparison_handler(candidate_handler),
+    setup_handler(setup_handler),
+    teardown_handler(teardown_handler),
+    failure_handler(failure_handler),
+    attributes(CASE_ATTRIBUTE_NONE),
+    stack_budget(0),
+    watchdog_ms(0)
+{}
+
+Case::Case(const char *description,
+           const case_benchmark_handler_t baseline_handler,
+           const case_benchmark_handler_t candidate_handler,
+           const case_failure_handler_t failure_handler) :
+    description(description),
+    handler(ignore_handler),
+    control_handler(ignore_handler),
+    repeat_count_handler(ignore_handler),
+    benchmark_handler(baseline_handler),
+    comparison_handler(candidate_handler),
+    setup_handler(default_handler),
+    teardown_handler(default_handler),
+    failure_handler(failure_handler),
+    attributes(CASE_ATTRIBUTE_NONE),
+    stack_budget(0),
+    watchdog_ms(0)
+{}
+
+Case::Case(const char *description,
+           const case_benchmark_handler_t baseline_handler,
+           const case_benchmark_handler_t candidate_handler,
+           const case_teardown_handler_t teardown_handler,
+           const case_failure_handler_t failure_handler) :
+    description(description),
+    handler(ignore_handler),
+    control_handler(ignore_handler),
+    repeat_count_handler(ignore_handler),
+    benchmark_handler(baseline_handler),
+    comparison_handler(candidate_handler),
+    setup_handler(default_handler),
+    teardown_handler(teardown_handler),
+    failure_handler(failure_handler),
+    attributes(CASE_ATTRIBUTE_NONE),
+    stack_budget(0),
+    watchdog_ms(0)
 {}
 
 const char*
@@ -147,5 +305,38 @@ Case::get_description() const {
 
 bool
 Case::is_empty() const {
-    return !(handler || control_handler || repeat_count_handler || setup_handler || teardown_handler);
+    return !(handler || control_handler || repeat_count_handler || benchmark_handler || setup_handler || teardown_handler);
+}
+
+Case&
+Case::with_attributes(const case_attribute_t attributes) {
+    this->attributes = case_attribute_t(this->attributes | attributes);
+    return *this;
+}
+
+case_attribute_t
+Case::get_attributes() const {
+    return attributes;
+}
+
+Case&
+Case::with_stack_budget(const size_t bytes) {
+    stack_budget = bytes;
+    return *this;
+}
+
+size_t
+Case::get_stack_budget() const {
+    return stack_budget;
+}
+
+Case&
+Case::with_watchdog(const uint32_t timeout_ms) {
+    watchdog_ms = timeout_ms;
+    return *this;
+}
+
+uint32_t
+Case::get_watchdog() const {
+    return watchdog_ms;
 }
@@ -0,0 +1,323 @@
+/****************************************************************************
+ * Copyright (c) 2016, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ****************************************************************************
+ */
+
+#include "utest/crash_guard.h"
+#include <stdio.h>
+
+using namespace utest::v1;
+
+#if UTEST_CRASH_GUARD_AVAILABLE
+
+#include <setjmp.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#if defined(__GLIBC__)
+#   include <execinfo.h>
+#endif
+#if UTEST_WATCHDOG_AVAILABLE
+#   include <time.h>
+#   include <sys/syscall.h>
+#endif
+
+#ifndef UTEST_WATCHDOG_SIGNAL
+#   define UTEST_WATCHDOG_SIGNAL SIGRTMIN
+#endif
+
+namespace
+{
+    const int guarded_signals[] = {SIGSEGV, SIGBUS, SIGILL, SIGFPE, SIGABRT};
+    const size_t guarded_signal_count = sizeof(guarded_signals) / sizeof(guarded_signals[0]);
+
+    // the actions of the guarded signals before the first guard was installed
+    struct sigaction previous_actions[guarded_signal_count];
+    size_t installed_guards = 0;
+
+    // the innermost `CrashGuard::call()` of the thread, which the signal handler jumps back into
+    struct call_t
+    {
+        sigjmp_buf environment;
+        call_t *previous;
+        uint32_t timeout_ms;    ///< non-zero, if the call armed the watchdog
+        int signal;
+        void *address;
+        void *frames[UTEST_CRASH_BACKTRACE_DEPTH];
+        int frame_count;
+    };
+    __thread call_t *current_call = NULL;
+
+    void handle_signal(int signal, siginfo_t *info, void *)
+    {
+        call_t *call = current_call;
+#if UTEST_WATCHDOG_AVAILABLE
+        if (signal == UTEST_WATCHDOG_SIGNAL) {
+            // the watchdog interrupts the innermost call that armed it, and is ignored once that call returned
+            while (call && call->timeout_ms == 0) call = call->previous;
+            if (call == NULL) return;
+        }
+        else
+#endif
+        if (call == NULL) {
+            // outside of a guarded call the signal takes its previous action once it is unblocked
+            for (size_t ii = 0; ii < guarded_signal_count; ii++) {
+                if (guarded_signals[ii] == signal) sigaction(signal, &previous_actions[ii], NULL);
+            }
+            raise(signal);
+            return;
+        }
+        call->signal = signal;
+        call->address = info->si_addr;
+#if defined(__GLIBC__)
+        call->frame_count = backtrace(call->frames, UTEST_CRASH_BACKTRACE_DEPTH);
+#else
+        call->frame_count = 0;
+#endif
+        current_call = call->previous;
+        siglongjmp(call->environment, 1);
+    }
+}
+
+#if UTEST_WATCHDOG_AVAILABLE
+
+// the timer signalling the thread that created it
+struct CrashGuard::watchdog_t
+{
+    timer_t timer;
+    pid_t process;
+    pid_t thread;
+};
+
+static bool is_watchdog_handled = false;
+
+static uint64_t get_remaining_ns(const struct itimerspec &value)
+{
+    return uint64_t(value.it_value.tv_sec) * 1000000000ull + value.it_value.tv_nsec;
+}
+
+static struct itimerspec get_timer_value(const uint64_t value_ns)
+{
+    struct itimerspec value;
+    memset(&value, 0, sizeof(value));
+    value.it_value.tv_sec = time_t(value_ns / 1000000000ull);
+    value.it_value.tv_nsec = long(value_ns % 1000000000ull);
+    return value;
+}
+
+static uint64_t get_monotonic_ns()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return uint64_t(now.tv_sec) * 1000000000ull + now.tv_nsec;
+}
+
+bool CrashGuard::arm_watchdog(const uint32_t timeout_ms, uint64_t &previous_ns)
+{
+    const pid_t thread = pid_t(syscall(SYS_gettid));
+    // timers are not inherited by forked processes, so the watchdog is recreated there
+    if (watchdog && watchdog->thread != thread) release_watchdog();
+    if (watchdog == NULL) {
+        if (!is_watchdog_handled) {
+            struct sigaction action;
+            memset(&action, 0, sizeof(action));
+            action.sa_sigaction = handle_signal;
+            action.sa_flags = SA_SIGINFO | SA_ONSTACK;
+            sigemptyset(&action.sa_mask);
+            if (sigaction(UTEST_WATCHDOG_SIGNAL, &action, NULL) != 0) return false;
+            is_watchdog_handled = true;
+        }
+        struct sigevent event;
+        memset(&event, 0, sizeof(event));
+        event.sigev_notify = SIGEV_THREAD_ID;
+        event.sigev_signo = UTEST_WATCHDOG_SIGNAL;
+        event._sigev_un._tid = thread;
+        timer_t timer;
+        if (timer_create(CLOCK_MONOTONIC, &event, &timer) != 0) return false;
+        watchdog = new watchdog_t();
+        watchdog->timer = timer;
+        watchdog->process = getpid();
+        watchdog->thread = thread;
+    }
+
+    // an enclosing call may have armed the watchdog already, which is restored by `disarm_watchdog()`
+    const struct itimerspec value = get_timer_value(uint64_t(timeout_ms) * 1000000ull);
+    struct itimerspec previous;
+    if (timer_settime(watchdog->timer, 0, &value, &previous) != 0) return false;
+    previous_ns = get_remaining_ns(previous);
+    if (previous_ns) previous_ns += get_monotonic_ns();
+    return true;
+}
+
+void CrashGuard::disarm_watchdog(const uint64_t previous_ns)
+{
+    uint64_t remaining_ns = 0;
+    if (previous_ns) {
+        const uint64_t now = get_monotonic_ns();
+        // an enclosing watchdog that expired in the meantime fires right away
+        remaining_ns = (previous_ns > now) ? (previous_ns - now) : 1;
+    }
+    const struct itimerspec value = get_timer_value(remaining_ns);
+    timer_settime(watchdog->timer, 0, &value, NULL);
+}
+
+void CrashGuard::release_watchdog()
+{
+    if (watchdog == NULL)
+        return;
+    // the timer identifiers of another process may identify a different timer in this process
+    if (watchdog->process == getpid()) timer_delete(watchdog->timer);
+    delete watchdog;
+    watchdog = NULL;
+}
+
+#else
+
+struct CrashGuard::watchdog_t {};
+
+// without per-thread timers the watchdog is never armed.
+bool CrashGuard::arm_watchdog(const uint32_t, uint64_t &) { return false; }
+void CrashGuard::disarm_watchdog(const uint64_t) {}
+void CrashGuard::release_watchdog() {}
+
+#endif
+
+CrashGuard::CrashGuard() :
+    signal(0), timed_out_ms(0), address(NULL), frame_count(0), signal_stack(NULL), watchdog(NULL), is_installed(false)
+{}
+
+CrashGuard::~CrashGuard()
+{
+    uninstall();
+    release_watchdog();
+    if (signal_stack == NULL)
+        return;
+    // the signal stack is only released, if it is no longer registered for the calling thread
+    stack_t stack;
+    if (sigaltstack(NULL, &stack) == 0 && stack.ss_sp == signal_stack) {
+        if (stack.ss_flags & SS_ONSTACK) return;
+        memset(&stack, 0, sizeof(stack));
+        stack.ss_flags = SS_DISABLE;
+        if (sigaltstack(&stack, NULL) != 0) return;
+        free(signal_stack);
+    }
+}
+
+bool CrashGuard::install()
+{
+    if (is_installed)
+        return true;
+
+#if defined(__GLIBC__)
+    // the first backtrace loads the unwinder, which must not happen inside the signal handler
+    void *frame;
+    backtrace(&frame, 1);
+#endif
+
+    // a stack overflow cannot be handled on the overflowing stack, an existing signal stack of the thread is kept
+    stack_t stack;
+    if (sigaltstack(NULL, &stack) != 0)
+        return false;
+    if (stack.ss_flags & SS_DISABLE) {
+        const size_t signal_stack_size = (SIGSTKSZ > 64 * 1024) ? SIGSTKSZ : 64 * 1024;
+        if (signal_stack == NULL) {
+            signal_stack = malloc(signal_stack_size);
+            if (signal_stack == NULL) return false;
+        }
+        memset(&stack, 0, sizeof(stack));
+        stack.ss_sp = signal_stack;
+        stack.ss_size = signal_stack_size;
+        if (sigaltstack(&stack, NULL) != 0)
+            return false;
+    }
+
+    if (installed_guards++ == 0) {
+        struct sigaction action;
+        memset(&action, 0, sizeof(action));
+        action.sa_sigaction = handle_signal;
+        action.sa_flags = SA_SIGINFO | SA_ONSTACK;
+        sigemptyset(&action.sa_mask);
+        for (size_t ii = 0; ii < guarded_signal_count; ii++)
+            sigaction(guarded_signals[ii], &action, &previous_actions[ii]);
+    }
+    is_installed = true;
+    return true;
+}
+
+void CrashGuard::uninstall()
+{
+    if (!is_installed)
+        return;
+    is_installed = false;
+    if (--installed_guards == 0) {
+        for (size_t ii = 0; ii < guarded_signal_count; ii++)
+            sigaction(guarded_signals[ii], &previous_actions[ii], NULL);
+    }
+}
+
+bool CrashGuard::call(void (*function)(void*), void *context, const uint32_t timeout_ms)
+{
+    call_t call;
+    call.previous = current_call;
+    uint64_t previous_ns = 0;
+    call.timeout_ms = (timeout_ms && arm_watchdog(timeout_ms, previous_ns)) ? timeout_ms : 0;
+
+    // the signal mask is restored by `siglongjmp()`, so that the next crash is delivered again
+    if (sigsetjmp(call.environment, 1) != 0) {
+        if (call.timeout_ms) disarm_watchdog(previous_ns);
+        signal = call.signal;
+        timed_out_ms = (signal == UTEST_WATCHDOG_SIGNAL) ? call.timeout_ms : 0;
+        address = call.address;
+        frame_count = call.frame_count;
+        memcpy(frames, call.frames, sizeof(void*) * frame_count);
+        return false;
+    }
+    current_call = &call;
+    function(context);
+    current_call = call.previous;
+    if (call.timeout_ms) disarm_watchdog(previous_ns);
+    return true;
+}
+
+void CrashGuard::print() const
+{
+    if (signal == 0)
+        return;
+    if (timed_out_ms) printf(">>> interrupted by the watchdog after %u ms\n", timed_out_ms);
+    else printf(">>> crashed with signal %d (%s) at address %p\n", signal, strsignal(signal), address);
+#if defined(__GLIBC__)
+    fflush(stdout);
+    backtrace_symbols_fd(const_cast<void *const *>(frames), frame_count, fileno(stdout));
+#endif
+}
+
+#else
+
+struct CrashGuard::watchdog_t {};
+
+// without POSIX signals the function is called unguarded.
+CrashGuard::CrashGuard() : signal(0), timed_out_ms(0), address(NULL), frame_count(0), signal_stack(NULL), watchdog(NULL), is_installed(false) {}
+CrashGuard::~CrashGuard() {}
+bool CrashGuard::install() { return false; }
+void CrashGuard::uninstall() {}
+bool CrashGuard::call(void (*function)(void*), void *context, const uint32_t) { function(context); return true; }
+bool CrashGuard::arm_watchdog(const uint32_t, uint64_t &) { return false; }
+void CrashGuard::disarm_watchdog(const uint64_t) {}
+void CrashGuard::release_watchdog() {}
+void CrashGuard::print() const {}
+
+#endif
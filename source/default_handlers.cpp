@@ -29,7 +29,10 @@ const handlers_t utest::v1::verbose_continue_handlers = {
     test_failure_handler,
     verbose_case_setup_handler,
     verbose_case_teardown_handler,
-    verbose_case_failure_handler
+    verbose_case_failure_handler,
+    verbose_case_benchmark_handler,
+    verbose_case_comparison_handler,
+    ignore_handler
 };
 
 
@@ -92,3 +95,57 @@ status_t utest::v1::verbose_case_failure_handler(const Case *const /*source*/, c
     if (failure.reason & REASON_IGNORE) return STATUS_IGNORE;
     return STATUS_CONTINUE;
 }
+
+void utest::v1::verbose_case_benchmark_handler(const Case *const source, const benchmark_result_t result)
+{
+    printf(">>> '%s': %.1f ns/op (min %.1f, median %.1f, p90 %.1f, p99 %.1f, stddev %.1f) over %u samples of %u iterations\n",
+           source->get_description(), result.mean_ns, result.min_ns, result.median_ns, result.p90_ns, result.p99_ns,
+           result.stddev_ns, result.samples, result.iterations);
+}
+
+void utest::v1::verbose_case_comparison_handler(const Case *const source, const benchmark_comparison_t comparison)
+{
+    printf(">>> '%s': candidate takes %.3fx the baseline (95%% confidence %.3fx to %.3fx), %.1f vs. %.1f ns/op over %u blocks\n",
+           source->get_description(), comparison.ratio, comparison.ratio_low, comparison.ratio_high,
+           comparison.candidate_ns, comparison.baseline_ns, comparison.blocks);
+}
+
+void utest::v1::verbose_case_metrics_handler(const Case *const source, const case_metrics_t &metrics)
+{
+    printf(">>> '%s': setup %.3f ms, handler %.3f ms, wait %.3f ms, teardown %.3f ms\n", source->get_description(),
+           metrics.setup_ns / 1e6, metrics.handler_ns / 1e6, metrics.wait_ns / 1e6, metrics.teardown_ns / 1e6);
+    if (metrics.callbacks) {
+        printf(">>> '%s': %u callbacks, latency up to %.3f ms using up to %u%% of the timeout, histogram",
+               source->get_description(), metrics.callbacks, metrics.latency_max_ns / 1e6, metrics.timeout_usage_max);
+        for (size_t ii = 0; ii < 10; ii++)
+            printf(" %u", metrics.timeout_usage[ii]);
+        printf("\n");
+    }
+    const heap_metrics_t *const heap[3] = {&metrics.setup_heap, &metrics.handler_heap, &metrics.teardown_heap};
+    if (heap[0]->allocations || heap[1]->allocations || heap[2]->allocations || metrics.leaked_bytes) {
+        printf(">>> '%s': allocations", source->get_description());
+        for (size_t ii = 0; ii < 3; ii++) {
+            printf(" %s %llu (%llu bytes, peak %llu),", (ii == 0) ? "setup" : ((ii == 1) ? "handler" : "teardown"),
+                   (unsigned long long) heap[ii]->allocations, (unsigned long long) heap[ii]->bytes, (unsigned long long) heap[ii]->peak_bytes);
+        }
+        printf(" leaked %lld bytes in %lld blocks\n", (long long) metrics.leaked_bytes, (long long) metrics.leaked_blocks);
+    }
+    if (metrics.arena_bytes) {
+        printf(">>> '%s': arena %u bytes\n", source->get_description(), metrics.arena_bytes);
+    }
+    if (metrics.stack_peak_bytes) {
+        printf(">>> '%s': stack peak %u bytes\n", source->get_description(), metrics.stack_peak_bytes);
+    }
+    uint64_t perf_total = 0;
+    for (size_t ii = 0; ii < PERF_COUNTER_COUNT; ii++)
+        perf_total += metrics.perf_counts[ii];
+    if (perf_total) {
+        const double cycles = double(metrics.perf_counts[PERF_CYCLES]);
+        printf(">>> '%s': %llu instructions, %llu cycles (%.2f IPC), %llu cache misses, %llu branch misses, %llu context switches\n",
+               source->get_description(),
+               (unsigned long long) metrics.perf_counts[PERF_INSTRUCTIONS], (unsigned long long) metrics.perf_counts[PERF_CYCLES],
+               cycles ? metrics.perf_counts[PERF_INSTRUCTIONS] / cycles : 0.0,
+               (unsigned long long) metrics.perf_counts[PERF_CACHE_MISSES], (unsigned long long) metrics.perf_counts[PERF_BRANCH_MISSES],
+               (unsigned long long) metrics.perf_counts[PERF_CONTEXT_SWITCHES]);
+    }
+}
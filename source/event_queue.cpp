@@ -0,0 +1,80 @@
+/****************************************************************************
+ * Copyright (c) 2016, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ****************************************************************************
+ */
+
+#include "utest/event_queue.h"
+#include "utest/atomic.h"
+
+using namespace utest::v1;
+
+// the positions are free-running and select their slot by masking
+typedef char event_queue_size_must_be_a_power_of_two[((UTEST_EVENT_QUEUE_SIZE & (UTEST_EVENT_QUEUE_SIZE - 1)) == 0) ? 1 : -1];
+static const size_t POSITION_MASK = UTEST_EVENT_QUEUE_SIZE - 1;
+
+EventQueue::EventQueue()
+{
+    enqueue_position = 0;
+    dequeue_position = 0;
+    for (size_t ii = 0; ii < UTEST_EVENT_QUEUE_SIZE; ii++) {
+        slots[ii].sequence = ii;
+    }
+}
+
+void EventQueue::clear()
+{
+    event_t event;
+    while (pop(event)) ;
+}
+
+bool EventQueue::push(const event_t &event)
+{
+    size_t position = enqueue_position;
+    slot_t *slot;
+    for (;;) {
+        slot = &slots[position & POSITION_MASK];
+        const size_t sequence = slot->sequence;
+        // the slot is free for this position, if the consumer released it one round ago
+        if (sequence == position) {
+            if (atomic_compare_exchange(enqueue_position, position, position + 1)) break;
+        }
+        // the slot still holds the event of the previous round
+        else if (ptrdiff_t(sequence - position) < 0) {
+            return false;
+        }
+        // another producer claimed the position in the meantime
+        position = enqueue_position;
+    }
+    slot->event = event;
+    // the event must be complete, before it is published to the consumer
+    atomic_fence();
+    slot->sequence = position + 1;
+    return true;
+}
+
+bool EventQueue::pop(event_t &event)
+{
+    slot_t &slot = slots[dequeue_position & POSITION_MASK];
+    // a claimed position blocks the consumer, until its producer published the event
+    if (slot.sequence != dequeue_position + 1)
+        return false;
+    atomic_fence();
+    event = slot.event;
+    atomic_fence();
+    slot.sequence = dequeue_position + UTEST_EVENT_QUEUE_SIZE;
+    dequeue_position++;
+    return true;
+}
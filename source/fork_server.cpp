@@ -0,0 +1,212 @@
+/****************************************************************************
+ * Copyright (c) 2016, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ****************************************************************************
+ */
+
+#include "utest/fork_server.h"
+
+using namespace utest::v1;
+
+#if UTEST_FORK_SERVER_AVAILABLE
+
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+
+// a client has this long to send its request, before its forked process gives up
+static const int request_timeout_s = 10;
+
+static volatile sig_atomic_t stop_requested = 0;
+
+static void stop_handler(int)
+{
+    stop_requested = 1;
+}
+
+static bool make_address(const char *path, struct sockaddr_un &address)
+{
+    if (path == NULL || strlen(path) >= sizeof(address.sun_path)) return false;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, path);
+    return true;
+}
+
+static bool read_request(const int fd, size_t &first, size_t &count)
+{
+    char line[64];
+    size_t length = 0;
+    while (length < sizeof(line) - 1) {
+        const ssize_t received = read(fd, &line[length], 1);
+        if (received < 0 && errno == EINTR) continue;
+        if (received <= 0) break;
+        if (line[length] == '\n') break;
+        length++;
+    }
+    line[length] = '\0';
+
+    unsigned long requested_first, requested_count;
+    if (sscanf(line, "%lu %lu", &requested_first, &requested_count) != 2) return false;
+    first = requested_first;
+    count = requested_count;
+    return true;
+}
+
+ForkServer::ForkServer() :
+    socket_fd(-1), server_pid(0), path(NULL), stopped(false)
+{}
+
+ForkServer::~ForkServer()
+{
+    if (socket_fd >= 0) close(socket_fd);
+    if (server_pid == getpid()) unlink(path);
+}
+
+bool ForkServer::serve(const char *path, size_t &first, size_t &count)
+{
+    struct sockaddr_un address;
+    if (!make_address(path, address)) return false;
+
+    socket_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (socket_fd < 0) return false;
+    // a previous server may not have removed its socket
+    unlink(path);
+    if (bind(socket_fd, (struct sockaddr*) &address, sizeof(address)) != 0) return false;
+    this->path = path;
+    server_pid = getpid();
+    if (listen(socket_fd, 16) != 0) return false;
+
+    // the stop signals are only delivered while waiting for a connection, so none can get lost
+    struct sigaction action, previous_term, previous_int;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = stop_handler;
+    sigemptyset(&action.sa_mask);
+    sigset_t stop_signals, previous_mask;
+    sigemptyset(&stop_signals);
+    sigaddset(&stop_signals, SIGTERM);
+    sigaddset(&stop_signals, SIGINT);
+    sigprocmask(SIG_BLOCK, &stop_signals, &previous_mask);
+    stop_requested = 0;
+    sigaction(SIGTERM, &action, &previous_term);
+    sigaction(SIGINT, &action, &previous_int);
+
+    bool is_forked = false;
+    while (!stop_requested)
+    {
+        // reap all finished processes
+        while (waitpid(-1, NULL, WNOHANG) > 0) ;
+
+        fd_set readable;
+        FD_ZERO(&readable);
+        FD_SET(socket_fd, &readable);
+        if (pselect(socket_fd + 1, &readable, NULL, NULL, NULL, &previous_mask) < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        const int connection = accept(socket_fd, NULL, NULL);
+        if (connection < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            break;
+        }
+
+        // otherwise buffered output is written by both processes
+        fflush(NULL);
+        const int pid = fork();
+        if (pid == 0) {
+            is_forked = true;
+            close(socket_fd);
+            socket_fd = -1;
+            // the request is read by the forked process, so a slow client does not hold up the others
+            struct timeval timeout = {request_timeout_s, 0};
+            setsockopt(connection, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+            if (!read_request(connection, first, count)) _exit(1);
+            dup2(connection, STDOUT_FILENO);
+            dup2(connection, STDERR_FILENO);
+            close(connection);
+            // keep the output, even if the process crashes
+            setvbuf(stdout, NULL, _IOLBF, BUFSIZ);
+            break;
+        }
+        close(connection);
+    }
+
+    sigaction(SIGTERM, &previous_term, NULL);
+    sigaction(SIGINT, &previous_int, NULL);
+    sigprocmask(SIG_SETMASK, &previous_mask, NULL);
+    if (is_forked) return true;
+
+    stopped = (stop_requested != 0);
+    close(socket_fd);
+    socket_fd = -1;
+    unlink(path);
+    server_pid = 0;
+    return false;
+}
+
+int ForkServer::request(const char *path, const size_t first, const size_t count, char *buffer, const size_t size)
+{
+    struct sockaddr_un address;
+    if (!make_address(path, address) || size == 0) return -1;
+
+    const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    // the server may still be running its test setup handler
+    int retries = 100;
+    while (connect(fd, (struct sockaddr*) &address, sizeof(address)) != 0) {
+        if (--retries == 0 || (errno != ENOENT && errno != ECONNREFUSED)) {
+            close(fd);
+            return -1;
+        }
+        usleep(10000);
+    }
+
+    char line[64];
+    const int length = snprintf(line, sizeof(line), "%lu %lu\n", (unsigned long) first, (unsigned long) count);
+    if (write(fd, line, length) != length) {
+        close(fd);
+        return -1;
+    }
+
+    size_t received = 0;
+    while (1) {
+        char discard[256];
+        const bool is_full = (received >= size - 1);
+        const ssize_t count = is_full ? read(fd, discard, sizeof(discard)) : read(fd, &buffer[received], size - 1 - received);
+        if (count < 0 && errno == EINTR) continue;
+        if (count <= 0) break;
+        if (!is_full) received += count;
+    }
+    buffer[received] = '\0';
+    close(fd);
+    return int(received);
+}
+
+#else
+
+// without `fork()` there is nothing to serve.
+ForkServer::ForkServer() : socket_fd(-1), server_pid(0), path(NULL), stopped(false) {}
+ForkServer::~ForkServer() {}
+bool ForkServer::serve(const char *, size_t &, size_t &) { return false; }
+int ForkServer::request(const char *, const size_t, const size_t, char *, const size_t) { return -1; }
+
+#endif
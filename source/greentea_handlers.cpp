@@ -33,7 +33,10 @@ const handlers_t utest::v1::greentea_abort_handlers = {
     test_failure_handler,
     greentea_case_setup_handler,
     greentea_case_teardown_handler,
-    greentea_case_failure_abort_handler
+    greentea_case_failure_abort_handler,
+    verbose_case_benchmark_handler,
+    verbose_case_comparison_handler,
+    ignore_handler
 };
 
 const handlers_t utest::v1::greentea_continue_handlers = {
@@ -42,7 +45,10 @@ const handlers_t utest::v1::greentea_continue_handlers = {
     test_failure_handler,
     greentea_case_setup_handler,
     greentea_case_teardown_handler,
-    greentea_case_failure_continue_handler
+    greentea_case_failure_continue_handler,
+    verbose_case_benchmark_handler,
+    verbose_case_comparison_handler,
+    ignore_handler
 };
 
 const handlers_t utest::v1::selftest_handlers = {
@@ -51,7 +57,10 @@ const handlers_t utest::v1::selftest_handlers = {
     selftest_failure_handler,
     greentea_case_setup_handler,
     greentea_case_teardown_handler,
-    greentea_case_failure_continue_handler
+    greentea_case_failure_continue_handler,
+    verbose_case_benchmark_handler,
+    verbose_case_comparison_handler,
+    ignore_handler
 };
 
 
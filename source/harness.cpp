@@ -17,65 +17,490 @@
  */
 
 #include "utest/harness.h"
+#include "utest/worker_pool.h"
+#include "utest/process_pool.h"
+#include "utest/fork_server.h"
+#include "utest/benchmark.h"
+#include "utest/perf_counters.h"
+#include "utest/stack_monitor.h"
+#include "utest/arena.h"
+#include "utest/crash_guard.h"
+#include "utest/heap_tracker.h"
+#include "utest/atomic.h"
 #include <stdlib.h>
 
 using namespace utest::v1;
 
+#ifndef UTEST_THREAD_LOCAL
+#   if defined(__GNUC__) && (defined(__linux__) || defined(__APPLE__))
+#       define UTEST_THREAD_LOCAL __thread
+#   else
+#       define UTEST_THREAD_LOCAL
+#   endif
+#endif
+
+// interrupt handlers must not execute the handlers of the harness, even if they preempt it on its own thread
+#ifndef UTEST_IS_INTERRUPT
+#   ifdef __MBED__
+#       include "cmsis.h"
+#   endif
+#   ifdef __CORTEX_M
+#       define UTEST_IS_INTERRUPT() (__get_IPSR() != 0)
+#   else
+#       define UTEST_IS_INTERRUPT() false
+#   endif
+#endif
+
+#ifndef UTEST_PARALLEL_CASE_FAILURES
+#   define UTEST_PARALLEL_CASE_FAILURES 4
+#endif
+
+struct HarnessContext::parallel_case_t
+{
+    failure_reason_t failures[UTEST_PARALLEL_CASE_FAILURES];
+    size_t failure_count;
+    bool is_joined;
+
+    void record(const failure_reason_t reason) {
+        // the last slot keeps the most recent reason, if there are too many failures
+        const size_t index = (failure_count < UTEST_PARALLEL_CASE_FAILURES) ? failure_count : (UTEST_PARALLEL_CASE_FAILURES - 1);
+        failures[index] = reason;
+        failure_count++;
+    }
+};
+
+struct HarnessContext::pipelined_case_t : HarnessContext::parallel_case_t
+{
+    HarnessContext *context;
+    const Case *source;
+    control_t control;                          ///< returned by the handler
+    control_t validated_control;                ///< passed to the validation
+    utest_v1_scheduler_handle_t timeout_handle;
+    uint64_t wait_start;
+    uint64_t wait_ns;                           ///< the time until the callback has been validated or timed out
+    case_metrics_t handler_metrics;             ///< measured while the handler was dispatched
+    case_metrics_t latencies;                   ///< the latencies of the validations, until the test case is joined
+    bool headroom_exceeded;
+    size_t validation_count;
+    bool is_validated;
+    bool timeout_occurred;
+};
+
 namespace
 {
-    const Case *test_cases = NULL;
-    size_t test_length = 0;
+    /// The run state of the parent that a test case in a forked process continues with.
+    struct isolated_case_job_t {
+        size_t case_index;
+        size_t test_index_of_case;
+        size_t test_passed;
+        size_t test_failed;
+    };
+    /// The result of a test case in a forked process.
+    struct isolated_case_result_t {
+        size_t case_index;
+        size_t case_passed;
+        size_t case_failed;
+        case_metrics_t case_metrics;
+    };
+
+    UTEST_THREAD_LOCAL HarnessContext *current_context = NULL;
+    // the `parallel_case_t` of the independent test case executing on this worker thread
+    UTEST_THREAD_LOCAL void *current_parallel_case = NULL;
+}
 
-    size_t test_index_of_case = 0;
+class HarnessContext::Scope
+{
+public:
+    Scope(HarnessContext *context) : previous(current_context) {
+        current_context = context;
+    }
+    ~Scope() {
+        current_context = previous;
+    }
+private:
+    HarnessContext *const previous;
+};
 
-    size_t test_passed = 0;
-    size_t test_failed = 0;
+static void die() {
+    while(1) ;
+}
 
-    const Case *case_current = NULL;
-    size_t case_index = 0;
-    control_t case_control = control_t(REPEAT_SETUP_TEARDOWN);
-    size_t case_repeat_count = 1;
+/// the arguments of a test failure handler executing under the watchdog
+struct test_failure_call_t
+{
+    test_failure_handler_t handler;
+    failure_t failure;
+};
 
-    void *case_timeout_handle = NULL;
-    size_t case_validation_count = 0;
-    bool case_timeout_occurred = false;
+static void call_test_failure_handler(void *context)
+{
+    const test_failure_call_t *const call = static_cast<test_failure_call_t*>(context);
+    call->handler(call->failure);
+}
 
-    size_t case_passed = 0;
-    size_t case_failed = 0;
-    size_t case_failed_before = 0;
+/// adds the time since `start` to the time spent in a phase of the test case
+static void add_elapsed(uint64_t &phase_ns, const uint64_t start)
+{
+    phase_ns += utest_v1_get_time_ns() - start;
+}
 
-    handlers_t defaults = default_handlers;
-    handlers_t handlers = defaults;
+/// @returns the time from `start` to `end`, which may have been taken before `start` on another thread
+static uint64_t get_interval(const uint64_t start, const uint64_t end)
+{
+    return (end > start) ? (end - start) : 0;
+}
 
-    location_t location = LOCATION_UNKNOWN;
+/// @returns the number of validations completing the wait of a test case
+static size_t get_required_validations(const control_t control)
+{
+    return control.get_await_count() ? control.get_await_count() : 1;
+}
 
-    utest_v1_scheduler_t scheduler = {NULL, NULL, NULL, NULL};
+/// adds the handler measurements of an overlapped test case to the metrics of the test case
+static void add_handler_metrics(case_metrics_t &metrics, const case_metrics_t &handler)
+{
+    metrics.handler_ns += handler.handler_ns;
+    metrics.handler_heap.allocations += handler.handler_heap.allocations;
+    metrics.handler_heap.bytes += handler.handler_heap.bytes;
+    if (handler.handler_heap.peak_bytes > metrics.handler_heap.peak_bytes) metrics.handler_heap.peak_bytes = handler.handler_heap.peak_bytes;
+    for (size_t ii = 0; ii < PERF_COUNTER_COUNT; ii++) metrics.perf_counts[ii] += handler.perf_counts[ii];
+    if (handler.stack_peak_bytes > metrics.stack_peak_bytes) metrics.stack_peak_bytes = handler.stack_peak_bytes;
 }
 
-static void die() {
-    while(1) ;
+/// adds the callback latencies recorded for an overlapped test case to the metrics of the test case
+static void add_latencies(case_metrics_t &metrics, const case_metrics_t &latencies)
+{
+    metrics.callbacks += latencies.callbacks;
+    if (latencies.latency_max_ns > metrics.latency_max_ns) metrics.latency_max_ns = latencies.latency_max_ns;
+    if (latencies.timeout_usage_max > metrics.timeout_usage_max) metrics.timeout_usage_max = latencies.timeout_usage_max;
+    for (size_t ii = 0; ii < 10; ii++) metrics.timeout_usage[ii] += latencies.timeout_usage[ii];
 }
 
-static bool is_scheduler_valid(const utest_v1_scheduler_t scheduler)
+static bool is_scheduler_valid(const utest_v1_scheduler_v2_t scheduler)
 {
-    return (scheduler.init && scheduler.post && scheduler.cancel && scheduler.run);
+    return (scheduler.version >= UTEST_V1_SCHEDULER_VERSION_2 &&
+            scheduler.init && scheduler.post && scheduler.cancel && scheduler.run);
 }
 
-bool Harness::set_scheduler(const utest_v1_scheduler_t scheduler)
+HarnessContext::HarnessContext() :
+    exit_on_finish(false)
+{
+    init();
+}
+
+HarnessContext::HarnessContext(const bool exit_on_finish) :
+    exit_on_finish(exit_on_finish)
+{
+    init();
+}
+
+void HarnessContext::init()
+{
+    utest_v1_scheduler_v2_t invalid = {0, NULL, NULL, NULL, NULL, NULL};
+    scheduler = invalid;
+    is_running_steps = false;
+    next_step = NULL;
+    test_cases = NULL;
+    case_current = NULL;
+    test_passed = 0;
+    test_failed = 0;
+    workers = NULL;
+    parallel_begin = NULL;
+    parallel_length = 0;
+    parallel_cases = NULL;
+    pipeline_depth = 0;
+    pipelined_begin = NULL;
+    pipelined_length = 0;
+    pipelined_cases = NULL;
+    pipelined_dispatch = NULL;
+    case_pipelined = NULL;
+    processes = NULL;
+    isolation_processes = 0;
+    isolation_timeout_ms = 0;
+    baseline = NULL;
+    comparison = NULL;
+    case_metrics = case_metrics_t();
+    case_wait_start = 0;
+    case_live_bytes = 0;
+    case_live_blocks = 0;
+    case_handler_allocations = 0;
+    perf_counters = NULL;
+    stack_monitor = NULL;
+    arena = NULL;
+    crash_guard = NULL;
+    watchdog_timeout_ms = 0;
+    events = NULL;
+    events_pending = false;
+    events_lost = 0;
+    case_timeout_handle = NULL;
+    step_handle = NULL;
+    drain_handle = NULL;
+}
+
+HarnessContext::~HarnessContext()
+{
+    // the callbacks still posted to the scheduler must not execute on the destroyed context
+    if (step_handle != NULL) scheduler.cancel(step_handle);
+    if (case_timeout_handle != NULL) scheduler.cancel(case_timeout_handle);
+    if (events_pending && drain_handle != NULL) scheduler.cancel(drain_handle);
+    release_parallel_cases();
+    release_pipelined_cases();
+    delete workers;
+    delete processes;
+    delete baseline;
+    delete comparison;
+    delete perf_counters;
+    delete stack_monitor;
+    delete arena;
+    delete crash_guard;
+    delete events;
+}
+
+HarnessContext &HarnessContext::get_default()
+{
+    static HarnessContext context(true);
+    return context;
+}
+
+HarnessContext &HarnessContext::get_current()
+{
+    if (current_context) return *current_context;
+    return get_default();
+}
+
+bool HarnessContext::set_scheduler(const utest_v1_scheduler_t scheduler)
+{
+    if (scheduler.init && scheduler.post && scheduler.cancel && scheduler.run) {
+        return set_scheduler(utest_v1_scheduler_adapt(scheduler));
+    }
+    return false;
+}
+
+bool HarnessContext::set_scheduler(const utest_v1_scheduler_v2_t scheduler)
 {
     if (is_scheduler_valid(scheduler)) {
-        ::scheduler = scheduler;
+        this->scheduler = scheduler;
         return true;
     }
     return false;
 }
 
-bool Harness::run(const Specification& specification, size_t)
+bool HarnessContext::set_workers(const size_t count)
 {
-    return run(specification);
+    if (is_busy())
+        return false;
+    if (workers == NULL) {
+        if (count == 0) return true;
+        workers = new WorkerPool();
+    }
+    return workers->start(count);
 }
 
-bool Harness::run(const Specification& specification)
+bool HarnessContext::set_pipelining(const size_t depth)
+{
+    if (is_busy())
+        return false;
+    pipeline_depth = depth;
+    return true;
+}
+
+bool HarnessContext::set_isolation(const size_t processes, const uint32_t timeout_ms)
+{
+    if (is_busy() || !UTEST_PROCESS_POOL_AVAILABLE)
+        return false;
+    if (this->processes == NULL)
+        this->processes = new ProcessPool();
+    this->processes->stop();
+    isolation_processes = processes;
+    isolation_timeout_ms = timeout_ms;
+    return true;
+}
+
+bool HarnessContext::set_baseline(const char *load_path, const char *save_path)
+{
+    if (is_busy())
+        return false;
+    if (load_path == NULL && save_path == NULL) {
+        delete baseline;
+        baseline = NULL;
+        return true;
+    }
+    if (baseline == NULL)
+        baseline = new BenchmarkBaseline();
+    return baseline->open(load_path, save_path);
+}
+
+bool HarnessContext::set_perf_counters(const bool enable)
+{
+    if (is_busy())
+        return false;
+    if (!enable) {
+        delete perf_counters;
+        perf_counters = NULL;
+        return true;
+    }
+    if (perf_counters == NULL)
+        perf_counters = new PerfCounters();
+    if (perf_counters->open())
+        return true;
+    delete perf_counters;
+    perf_counters = NULL;
+    return false;
+}
+
+bool HarnessContext::set_stack_monitor(const size_t size)
+{
+    if (is_busy())
+        return false;
+    if (size == 0) {
+        delete stack_monitor;
+        stack_monitor = NULL;
+        return true;
+    }
+    if (stack_monitor == NULL)
+        stack_monitor = new StackMonitor();
+    if (stack_monitor->allocate(size))
+        return true;
+    delete stack_monitor;
+    stack_monitor = NULL;
+    return false;
+}
+
+bool HarnessContext::set_stack_monitor(void *base, const size_t size)
+{
+    if (is_busy())
+        return false;
+    if (base == NULL || size == 0) {
+        delete stack_monitor;
+        stack_monitor = NULL;
+        return true;
+    }
+    if (stack_monitor == NULL)
+        stack_monitor = new StackMonitor();
+    stack_monitor->release();
+    stack_monitor->attach(base, size);
+    return true;
+}
+
+bool HarnessContext::set_arena(const size_t size, const bool huge_pages)
+{
+    if (is_busy())
+        return false;
+    if (size == 0) {
+        delete arena;
+        arena = NULL;
+        return true;
+    }
+    if (arena == NULL)
+        arena = new Arena();
+    if (arena->reserve(size, huge_pages))
+        return true;
+    delete arena;
+    arena = NULL;
+    return false;
+}
+
+void *HarnessContext::allocate(const size_t size)
+{
+    // independent test cases would race with each other and with the reset after the current test case,
+    // overlapped test cases would keep using their memory after the reset
+    if (arena == NULL || current_parallel_case || pipelined_dispatch)
+        return NULL;
+    return arena->allocate(size);
+}
+
+bool HarnessContext::set_crash_guard(const bool enable)
+{
+    if (is_busy())
+        return false;
+    // the guard also executes the watchdog, so it is only uninstalled
+    if (!enable) {
+        if (crash_guard) crash_guard->uninstall();
+        return true;
+    }
+    if (crash_guard == NULL)
+        crash_guard = new CrashGuard();
+    return crash_guard->install();
+}
+
+bool HarnessContext::set_watchdog(const uint32_t timeout_ms)
+{
+    if (is_busy() || !UTEST_WATCHDOG_AVAILABLE)
+        return false;
+    if (timeout_ms && crash_guard == NULL)
+        crash_guard = new CrashGuard();
+    watchdog_timeout_ms = timeout_ms;
+    return true;
+}
+
+bool HarnessContext::run(const Specification& specification)
+{
+    if (!start(specification))
+        return false;
+
+    run_scheduler();
+    return true;
+}
+
+bool HarnessContext::serve(const Specification& specification, const char *path)
+{
+    if (!setup(specification))
+        return false;
+    // the test setup handler failed or aborted the specification
+    if (test_cases == NULL)
+        return true;
+
+    ForkServer server;
+    size_t first, count;
+    if (!server.serve(path, first, count)) {
+        test_cases = NULL;
+        return server.was_stopped();
+    }
+
+    // this process was forked for a request, so it starts directly at the first requested test case
+    if (first > test_length) first = test_length;
+    if (count && count < test_length - first) test_length = first + count;
+    case_index = first;
+    case_current = &test_cases[case_index];
+    test_index_of_case = case_index;
+    // a forked process always exits once its test cases finished
+    exit_on_finish = true;
+    // the worker threads have not been forked along
+    workers = NULL;
+    // the inherited counters still count the thread of the parent
+    if (perf_counters) perf_counters->open();
+    if (scheduler.init() != 0)
+        exit(1);
+
+    step_handle = scheduler.post(run_next_case, this, 0);
+    run_scheduler();
+    return true;
+}
+
+void HarnessContext::run_scheduler()
+{
+    if (scheduler.run() != 0) {
+        Scope scope(this);
+        const failure_t failure(REASON_SCHEDULER, LOCATION_TEST_SETUP);
+        call_test_failure(failure);
+        if (handlers.test_teardown) handlers.test_teardown(0, 0, failure);
+        finish(failure, 1);
+    }
+}
+
+bool HarnessContext::start(const Specification& specification)
+{
+    if (!setup(specification))
+        return false;
+    // the test setup handler failed or aborted the specification
+    if (test_cases == NULL)
+        return true;
+
+    step_handle = scheduler.post(run_next_case, this, 0);
+    return true;
+}
+
+bool HarnessContext::setup(const Specification& specification)
 {
     // check if a specification is currently running
     if (is_busy())
@@ -83,17 +508,27 @@ bool Harness::run(const Specification& specification)
 
     // if the scheduler is invalid, this is the first time we are calling
     if (!is_scheduler_valid(scheduler))
-        scheduler = utest_v1_get_scheduler();
+        scheduler = utest_v1_get_scheduler_v2();
     // if the scheduler is still invalid, abort
     if (!is_scheduler_valid(scheduler))
         return false;
     // if the scheduler failed to initialize, abort
     if (scheduler.init() != 0)
         return false;
+    // start the configured number of workers the first time we are calling
+    if (workers == NULL && UTEST_WORKER_POOL_SIZE > 0)
+        set_workers(UTEST_WORKER_POOL_SIZE);
+    // the events of an aborted specification do not belong to this one
+    if (events == NULL) events = new EventQueue();
+    else events->clear();
+    events_lost = 0;
+
+    Scope scope(this);
 
     test_cases  = specification.cases;
     test_length = specification.length;
     defaults    = specification.defaults;
+    handlers    = defaults;
     handlers.test_setup    = defaults.get_handler(specification.setup_handler);
     handlers.test_teardown = defaults.get_handler(specification.teardown_handler);
     handlers.test_failure  = defaults.get_handler(specification.failure_handler);
@@ -101,10 +536,23 @@ bool Harness::run(const Specification& specification)
     test_index_of_case = 0;
     test_passed = 0;
     test_failed = 0;
+    test_failure = failure_t(REASON_NONE);
+
+    case_control = control_t(REPEAT_SETUP_TEARDOWN);
+    case_repeat_count = 1;
+    case_timeout_handle = NULL;
+    case_validation_count = 0;
+    case_state = CASE_STATE_IDLE;
+    case_validated_control = control_t();
+    case_validated_ns = 0;
+    case_timeout_occurred = false;
+    case_headroom_exceeded = false;
+    case_pipelined = NULL;
 
     case_passed = 0;
     case_failed = 0;
     case_failed_before = 0;
+    case_metrics = case_metrics_t();
 
     location = LOCATION_TEST_SETUP;
     int setup_status = 0;
@@ -118,48 +566,90 @@ bool Harness::run(const Specification& specification)
     }
 
     if (failure.reason != REASON_NONE) {
-        if (handlers.test_failure) handlers.test_failure(failure);
+        call_test_failure(failure);
         if (handlers.test_teardown) handlers.test_teardown(0, 0, failure);
-        test_cases = NULL;
-        exit(1);
+        finish(failure, 1);
         return true;
     }
+    // an assertion in the test setup handler may have aborted the specification
+    if (test_cases == NULL)
+        return true;
 
     case_index = setup_status;
     case_current = &test_cases[case_index];
+    // the allocations of the test setup handler do not belong to the first test case
+    reset_case_metrics();
+    return true;
+}
 
-    scheduler.post(run_next_case, 0);
-    if (scheduler.run() != 0) {
-        failure.reason = REASON_SCHEDULER;
-        if (handlers.test_failure) handlers.test_failure(failure);
-        if (handlers.test_teardown) handlers.test_teardown(0, 0, failure);
-        test_cases = NULL;
-        exit(1);
-        return true;
+void HarnessContext::finish(const failure_t failure, const int status)
+{
+    // the workers may still execute test cases, which have not been joined
+    release_parallel_cases();
+    release_pipelined_cases();
+    if (processes) processes->stop();
+    test_failure = failure;
+    test_cases = NULL;
+    if (exit_on_finish) {
+        exit(status);
+        die();
     }
-    return true;
+    if (case_timeout_handle != NULL) {
+        scheduler.cancel(case_timeout_handle);
+        case_timeout_handle = NULL;
+    }
+    case_state = CASE_STATE_IDLE;
 }
 
-void Harness::raise_failure(const failure_reason_t reason)
+void HarnessContext::call_test_failure(const failure_t failure)
+{
+    if (!handlers.test_failure)
+        return;
+    // the default handlers halt after a failure of the test setup or teardown, which the watchdog interrupts,
+    // so that the specification finishes
+    if (crash_guard && watchdog_timeout_ms) {
+        test_failure_call_t call = {handlers.test_failure, failure};
+        crash_guard->call(call_test_failure_handler, &call, watchdog_timeout_ms);
+    }
+    else handlers.test_failure(failure);
+}
+
+void HarnessContext::raise_failure(const failure_reason_t reason)
 {
+    // failures of independent test cases are replayed when the test case is joined
+    if (current_parallel_case) {
+        static_cast<parallel_case_t*>(current_parallel_case)->record(reason);
+        return;
+    }
+
     // ignore a failure, if the Harness has not been initialized.
     // this allows using unity assertion macros without setting up utest.
     if (test_cases == NULL) return;
 
-    status_t fail_status = STATUS_ABORT;
-    {
-        UTEST_ENTER_CRITICAL_SECTION;
+    // the handlers must not execute concurrently with the harness or inside an interrupt,
+    // so failures raised elsewhere are handled once the thread executing this context drains its events
+    if (!is_executing()) {
+        post_event(EventQueue::EVENT_FAILURE, NULL, control_t(), reason);
+        return;
+    }
+    // failures of overlapped test cases, whose handler is dispatched ahead of them, are replayed as well
+    if (pipelined_dispatch) {
+        pipelined_dispatch->record(reason);
+        return;
+    }
 
-        if (handlers.test_failure) handlers.test_failure(failure_t(reason, location));
-        if (handlers.case_failure) fail_status = handlers.case_failure(case_current, failure_t(reason, location));
-        if (fail_status != STATUS_IGNORE) case_failed++;
+    call_test_failure(failure_t(reason, location));
+    status_t fail_status = STATUS_ABORT;
+    if (handlers.case_failure) fail_status = handlers.case_failure(case_current, failure_t(reason, location));
+    if (fail_status != STATUS_IGNORE) case_failed++;
 
-        if ((fail_status == STATUS_ABORT) && case_timeout_handle)
-        {
+    // the abort ends the wait, unless a validation or the timeout completed it first
+    if (fail_status == STATUS_ABORT && change_case_state(CASE_STATE_AWAITING, CASE_STATE_COMPLETED)) {
+        if (case_timeout_handle != NULL) {
             scheduler.cancel(case_timeout_handle);
             case_timeout_handle = NULL;
         }
-        UTEST_LEAVE_CRITICAL_SECTION;
+        add_elapsed(case_metrics.wait_ns, case_wait_start);
     }
 
     if (fail_status == STATUS_ABORT || reason & REASON_CASE_SETUP) {
@@ -167,7 +657,12 @@ void Harness::raise_failure(const failure_reason_t reason)
             location_t fail_loc(location);
             location = LOCATION_CASE_TEARDOWN;
 
+            HeapTracker::snapshot_t heap;
+            HeapTracker::start(heap);
+            const uint64_t teardown_start = utest_v1_get_time_ns();
             status_t teardown_status = handlers.case_teardown(case_current, case_passed, case_failed, failure_t(reason, fail_loc));
+            add_elapsed(case_metrics.teardown_ns, teardown_start);
+            HeapTracker::stop(heap, case_metrics.teardown_heap);
             if (teardown_status < STATUS_CONTINUE) raise_failure(REASON_CASE_TEARDOWN);
             else if (teardown_status > signed(test_length)) raise_failure(REASON_CASE_INDEX);
             else if (teardown_status >= 0) case_index = teardown_status - 1;
@@ -175,18 +670,57 @@ void Harness::raise_failure(const failure_reason_t reason)
             handlers.case_teardown = NULL;
         }
     }
-    if (fail_status == STATUS_ABORT) {
+    // the teardown handler may already have aborted the specification
+    if (fail_status == STATUS_ABORT && test_cases != NULL) {
+        // only the forked process of this test case is aborted
+        if (processes && processes->is_forked()) report_isolated_case();
+
+        report_case_metrics();
         test_failed++;
         failure_t fail(reason, location);
         location = LOCATION_TEST_TEARDOWN;
         if (handlers.test_teardown) handlers.test_teardown(test_passed, test_failed, fail);
-        exit(test_failed);
-        die();
+        finish(fail, test_failed);
     }
 }
 
-void Harness::schedule_next_case()
+void HarnessContext::raise_failure(const Case *const source, const failure_reason_t reason)
+{
+    // the overlapped test cases are only accessed by the thread executing this context
+    if (is_executing()) raise_source_failure(source, reason);
+    else post_event(EventQueue::EVENT_FAILURE, source, control_t(), reason);
+}
+
+void HarnessContext::raise_source_failure(const Case *const source, const failure_reason_t reason)
 {
+    pipelined_case_t *const pipelined = find_pipelined_case(source);
+    if (pipelined) pipelined->record(reason);
+    else if (source == case_current) raise_failure(reason);
+}
+
+void HarnessContext::schedule_next_case(void *context)
+{
+    HarnessContext *self = static_cast<HarnessContext*>(context);
+    self->step_handle = NULL;
+    self->run_steps(&HarnessContext::schedule_next_case);
+}
+
+void HarnessContext::schedule_next_case()
+{
+    // the specification may have been aborted in the meantime
+    if (test_cases == NULL) return;
+
+    // failures raised by other threads until now belong to this test case
+    handle_events();
+    if (test_cases == NULL) return;
+
+    // the warning is raised here, since the callback may have been validated from an interrupt or another thread
+    if (case_headroom_exceeded) {
+        case_headroom_exceeded = false;
+        raise_failure(failure_reason_t(REASON_TIMEOUT_HEADROOM | REASON_IGNORE));
+        if (test_cases == NULL) return;
+    }
+
     if (!case_timeout_occurred && case_failed_before == case_failed) {
         case_passed++;
     }
@@ -195,148 +729,987 @@ void Harness::schedule_next_case()
         location = LOCATION_CASE_TEARDOWN;
 
         if (handlers.case_teardown) {
+            HeapTracker::snapshot_t heap;
+            HeapTracker::start(heap);
+            const uint64_t teardown_start = utest_v1_get_time_ns();
             status_t status = handlers.case_teardown(case_current, case_passed, case_failed,
                                                      case_failed ? failure_t(REASON_CASES, LOCATION_UNKNOWN) : failure_t(REASON_NONE));
+            add_elapsed(case_metrics.teardown_ns, teardown_start);
+            HeapTracker::stop(heap, case_metrics.teardown_heap);
             if (status < STATUS_CONTINUE)          raise_failure(REASON_CASE_TEARDOWN);
             else if (status > signed(test_length)) raise_failure(REASON_CASE_INDEX);
             else if (status >= 0) case_index = status - 1;
+            if (test_cases == NULL) return;
         }
     }
 
     if (!(case_control.repeat & (REPEAT_ON_TIMEOUT | REPEAT_ON_VALIDATE))) {
-        if (case_failed > 0) test_failed++;
-        else test_passed++;
-
-        case_control = control_t(REPEAT_SETUP_TEARDOWN);
-        case_index++;
-        case_current = &test_cases[case_index];
-        case_passed = 0;
-        case_failed = 0;
-        case_failed_before = 0;
-        case_repeat_count = 1;
-        test_index_of_case++;
+        // the forked process of this test case is done
+        if (processes && processes->is_forked()) report_isolated_case();
+        next_case();
     }
-    scheduler.post(run_next_case, 0);
+    post_step(&HarnessContext::run_next_case, run_next_case);
 }
 
-void Harness::handle_timeout()
+void HarnessContext::next_case()
 {
-    {
-        UTEST_ENTER_CRITICAL_SECTION;
+    report_case_metrics();
+    if (case_failed > 0) test_failed++;
+    else test_passed++;
 
-        if (case_timeout_handle != NULL) {
-            case_timeout_handle = NULL;
-            case_timeout_occurred = true;
-        }
-        UTEST_LEAVE_CRITICAL_SECTION;
-    }
-    if (case_timeout_occurred) {
-        raise_failure(failure_reason_t(REASON_TIMEOUT | ((case_control.repeat & REPEAT_ON_TIMEOUT) ? REASON_IGNORE : 0)));
-        scheduler.post(schedule_next_case, 0);
-    }
+    case_control = control_t(REPEAT_SETUP_TEARDOWN);
+    case_index++;
+    case_current = &test_cases[case_index];
+    case_passed = 0;
+    case_failed = 0;
+    case_failed_before = 0;
+    case_repeat_count = 1;
+    reset_case_metrics();
+    // all allocations of the finished test case are released at once
+    if (arena) arena->reset();
+    test_index_of_case++;
 }
 
-void Harness::validate_callback(const control_t control)
+void HarnessContext::reset_case_metrics()
 {
-    UTEST_ENTER_CRITICAL_SECTION;
-    case_validation_count++;
+    case_metrics = case_metrics_t();
+    case_live_bytes = HeapTracker::get_live_bytes();
+    case_live_blocks = HeapTracker::get_live_blocks();
+}
 
-    if (case_timeout_handle != NULL || case_control.timeout == TIMEOUT_FOREVER)
-    {
-        scheduler.cancel(case_timeout_handle);
-        case_timeout_handle = NULL;
-        control_t merged_control = case_control + control;
-        case_control.repeat = repeat_t(merged_control.repeat & ~REPEAT_ON_TIMEOUT);
-        case_control.timeout = TIMEOUT_NONE;
-        scheduler.post(schedule_next_case, 0);
+void HarnessContext::record_latency(case_metrics_t &metrics, bool &headroom_exceeded, const uint32_t timeout, const uint64_t latency_ns)
+{
+    // the validations of a test case awaiting several callbacks may be recorded concurrently
+    atomic_add(metrics.callbacks, size_t(1));
+    atomic_max(metrics.latency_max_ns, latency_ns);
+
+    if (timeout >= TIMEOUT_FOREVER || timeout == 0)
+        return;
+    const uint64_t timeout_ns = uint64_t(timeout) * 1000000ull;
+    // the timeout may have been delayed, when the callback raced with it
+    const uint32_t usage = (latency_ns >= timeout_ns) ? 100 : uint32_t((latency_ns * 100) / timeout_ns);
+    atomic_add(metrics.timeout_usage[(usage < 100) ? (usage / 10) : 9], size_t(1));
+    atomic_max(metrics.timeout_usage_max, usage);
+    if (usage + UTEST_TIMEOUT_HEADROOM_PERCENT > 100) headroom_exceeded = true;
+}
+
+void HarnessContext::measure_case_usage()
+{
+    // a forked process reports the usage of its own stack and arena, which exceeds the one of the parent
+    if (stack_monitor) {
+        const size_t peak = stack_monitor->get_peak();
+        if (peak > case_metrics.stack_peak_bytes) case_metrics.stack_peak_bytes = peak;
     }
-    UTEST_LEAVE_CRITICAL_SECTION;
+    if (arena && arena->get_used() > case_metrics.arena_bytes)
+        case_metrics.arena_bytes = arena->get_used();
 }
 
-bool Harness::is_busy()
+void HarnessContext::report_case_metrics()
 {
-    UTEST_ENTER_CRITICAL_SECTION;
-    if (!test_cases)   return false;
-    if (!case_current) return false;
+    measure_case_usage();
+    case_metrics.leaked_bytes = HeapTracker::get_live_bytes() - case_live_bytes;
+    case_metrics.leaked_blocks = HeapTracker::get_live_blocks() - case_live_blocks;
+    if (handlers.case_metrics) handlers.case_metrics(case_current, case_metrics);
+}
 
-    bool res = (case_current < (test_cases + test_length));
-    UTEST_LEAVE_CRITICAL_SECTION;
-    return res;
+void HarnessContext::handle_timeout(void *context)
+{
+    HarnessContext *self = static_cast<HarnessContext*>(context);
+    Scope scope(self);
+    self->handle_timeout();
 }
 
-void Harness::run_next_case()
+void HarnessContext::handle_timeout()
 {
-    if(case_current < (test_cases + test_length))
-    {
-        handlers.case_setup    = defaults.get_handler(case_current->setup_handler);
-        handlers.case_teardown = defaults.get_handler(case_current->teardown_handler);
-        handlers.case_failure  = defaults.get_handler(case_current->failure_handler);
+    // the timeout executed, so its handle must not be canceled anymore
+    case_timeout_handle = NULL;
+    // the validation completing the wait may have been faster, its completion is then still pending
+    if (!change_case_state(CASE_STATE_AWAITING, CASE_STATE_COMPLETED))
+        return;
 
-        if (case_current->is_empty()) {
-            location = LOCATION_UNKNOWN;
-            raise_failure(REASON_EMPTY_CASE);
-            schedule_next_case();
-            return;
-        }
+    case_timeout_occurred = true;
+    add_elapsed(case_metrics.wait_ns, case_wait_start);
+    raise_failure(failure_reason_t(REASON_TIMEOUT | ((case_control.repeat & REPEAT_ON_TIMEOUT) ? REASON_IGNORE : 0)));
+    if (test_cases != NULL) step_handle = scheduler.post(schedule_next_case, this, 0);
+}
 
-        repeat_t setup_repeat;
-        {
-            UTEST_ENTER_CRITICAL_SECTION;
-            case_validation_count = 0;
-            case_timeout_occurred = false;
-            setup_repeat = case_control.repeat;
-            case_control = control_t();
-            UTEST_LEAVE_CRITICAL_SECTION;
+void HarnessContext::validate_callback(const control_t control)
+{
+    count_validation(control, utest_v1_get_time_ns());
+}
+
+void HarnessContext::count_validation(const control_t control, const uint64_t time_ns)
+{
+    // the latency is recorded first, so that all validations counted towards the completion have been recorded
+    if (case_state == CASE_STATE_AWAITING)
+        record_latency(case_metrics, case_headroom_exceeded, case_control.timeout, get_interval(case_wait_start, time_ns));
+    const size_t count = atomic_add(case_validation_count, size_t(1));
+
+    // only the validation with the required count competes with the timeout and the harness starting the wait.
+    // the required count is final once the handler returned, which the harness announces with `CASE_STATE_STARTING`.
+    uint32_t state;
+    do {
+        state = case_state;
+        if ((state != CASE_STATE_STARTING && state != CASE_STATE_AWAITING) || count != get_required_validations(case_control))
+            return;
+        case_validated_control = control;
+        case_validated_ns = time_ns;
+    } while (!change_case_state(state, CASE_STATE_VALIDATED));
+
+    // a wait that is still starting is completed by the harness itself
+    if (state == CASE_STATE_AWAITING) {
+        if (is_executing()) complete_wait();
+        else if (atomic_compare_exchange(events_pending, false, true)) drain_handle = scheduler.post(drain_events, this, 0);
+    }
+}
+
+void HarnessContext::complete_wait()
+{
+    if (!change_case_state(CASE_STATE_VALIDATED, CASE_STATE_COMPLETED))
+        return;
+    if (case_timeout_handle != NULL) {
+        scheduler.cancel(case_timeout_handle);
+        case_timeout_handle = NULL;
+    }
+    case_metrics.wait_ns += get_interval(case_wait_start, case_validated_ns);
+    control_t merged_control = case_control + case_validated_control;
+    case_control.repeat = repeat_t(merged_control.repeat & ~REPEAT_ON_TIMEOUT);
+    case_control.timeout = TIMEOUT_NONE;
+    step_handle = scheduler.post(schedule_next_case, this, 0);
+}
+
+bool HarnessContext::change_case_state(const uint32_t from, const uint32_t to)
+{
+    return atomic_compare_exchange(case_state, from, to);
+}
+
+void HarnessContext::validate_callback(const Case *const source, const control_t control)
+{
+    // the overlapped test cases are only accessed by the thread executing this context
+    if (is_executing()) validate_source(source, control, utest_v1_get_time_ns());
+    else post_event(EventQueue::EVENT_VALIDATION, source, control, REASON_NONE);
+}
+
+void HarnessContext::validate_source(const Case *const source, const control_t control, const uint64_t time_ns)
+{
+    pipelined_case_t *const pipelined = find_pipelined_case(source);
+    // the test case has been joined already or was never overlapped
+    if (pipelined == NULL) {
+        if (source == case_current) count_validation(control, time_ns);
+        return;
+    }
+
+    pipelined->validation_count++;
+    const bool is_awaiting = !pipelined->is_validated &&
+                             (pipelined->timeout_handle != NULL || pipelined->control.timeout == TIMEOUT_FOREVER);
+    if (is_awaiting) {
+        record_latency(pipelined->latencies, pipelined->headroom_exceeded, pipelined->control.timeout,
+                       get_interval(pipelined->wait_start, time_ns));
+    }
+    if (is_awaiting && pipelined->validation_count >= get_required_validations(pipelined->control))
+    {
+        if (pipelined->timeout_handle != NULL) scheduler.cancel(pipelined->timeout_handle);
+        pipelined->timeout_handle = NULL;
+        pipelined->wait_ns = get_interval(pipelined->wait_start, time_ns);
+        pipelined->validated_control = control;
+        pipelined->is_validated = true;
+    }
+}
+
+bool HarnessContext::is_executing() const
+{
+    return (current_context == this) && !UTEST_IS_INTERRUPT();
+}
+
+void HarnessContext::post_event(const EventQueue::event_type_t type, const Case *const source,
+                                const control_t control, const failure_reason_t reason)
+{
+    if (events == NULL)
+        return;
+    EventQueue::event_t event;
+    event.type = type;
+    event.source = source;
+    event.control = control;
+    event.reason = reason;
+    event.time_ns = utest_v1_get_time_ns();
+    // the dropped event is reported as a scheduler failure, once the queue has been drained
+    if (!events->push(event)) atomic_add(events_lost, size_t(1));
+    if (atomic_compare_exchange(events_pending, false, true)) drain_handle = scheduler.post(drain_events, this, 0);
+}
+
+void HarnessContext::drain_events(void *context)
+{
+    HarnessContext *self = static_cast<HarnessContext*>(context);
+    self->drain_handle = NULL;
+    Scope scope(self);
+    self->drain_events();
+}
+
+void HarnessContext::drain_events()
+{
+    // events posted from now on post another drain, events posted before are drained now
+    events_pending = false;
+    atomic_fence();
+    handle_events();
+    // the completion of the wait is handled after the failures, which were raised before it
+    complete_wait();
+}
+
+void HarnessContext::handle_events()
+{
+    EventQueue::event_t event;
+    while (events->pop(event)) {
+        // the specification may have been aborted in the meantime
+        if (test_cases == NULL) continue;
+        if (event.type == EventQueue::EVENT_VALIDATION) validate_source(event.source, event.control, event.time_ns);
+        else if (event.source) raise_source_failure(event.source, event.reason);
+        else raise_failure(event.reason);
+    }
+    const size_t lost = events_lost;
+    if (lost) {
+        atomic_add(events_lost, size_t(0) - lost);
+        if (test_cases != NULL) raise_failure(REASON_SCHEDULER);
+    }
+}
+
+const Case *HarnessContext::get_current_case() const
+{
+    if (test_cases == NULL) return NULL;
+    if (pipelined_dispatch) return pipelined_dispatch->source;
+    return case_current;
+}
+
+bool HarnessContext::is_busy() const
+{
+    UTEST_ENTER_CRITICAL_SECTION;
+    bool res = false;
+    if (test_cases && case_current) {
+        res = (case_current < (test_cases + test_length));
+    }
+    UTEST_LEAVE_CRITICAL_SECTION;
+    return res;
+}
+
+void HarnessContext::run_next_case(void *context)
+{
+    HarnessContext *self = static_cast<HarnessContext*>(context);
+    self->step_handle = NULL;
+    self->run_steps(&HarnessContext::run_next_case);
+}
+
+void HarnessContext::resume_steps(void *context)
+{
+    HarnessContext *self = static_cast<HarnessContext*>(context);
+    self->run_steps(self->next_step);
+}
+
+// --- SYNCHRONOUS STEPS ---
+void HarnessContext::run_steps(step_t step)
+{
+    // all steps execute on the monitored alternate stack, if there is one
+    if (stack_monitor && stack_monitor->is_allocated() && !stack_monitor->is_executing()) {
+        next_step = step;
+        stack_monitor->run(resume_steps, this);
+        return;
+    }
+    Scope scope(this);
+    // the steps of synchronous test cases follow each other in this loop, without growing the stack
+    is_running_steps = true;
+    while (step) {
+        next_step = NULL;
+        (this->*step)();
+        step = next_step;
+    }
+    is_running_steps = false;
+}
+
+void HarnessContext::post_step(const step_t step, const utest_v1_harness_callback_v2_t callback)
+{
+    // inside `run_steps()` the next step is executed directly, instead of taking a round-trip through the scheduler
+    if (is_running_steps) next_step = step;
+    else step_handle = scheduler.post(callback, this, 0);
+}
+
+void HarnessContext::run_next_case()
+{
+    // the specification may have been aborted in the meantime
+    if (test_cases == NULL) return;
+
+    if(case_current < (test_cases + test_length))
+    {
+        // the stack is painted before each test case and measured after its last teardown
+        if (stack_monitor && case_repeat_count == 1 && (case_control.repeat & REPEAT_SETUP_TEARDOWN))
+            stack_monitor->paint();
+
+        // in the parent the test case executes in a forked process
+        if (isolation_processes && run_isolated_case()) return;
+
+        handlers.case_setup    = defaults.get_handler(case_current->setup_handler);
+        handlers.case_teardown = defaults.get_handler(case_current->teardown_handler);
+        handlers.case_failure  = defaults.get_handler(case_current->failure_handler);
+
+        if (case_current->is_empty()) {
+            location = LOCATION_UNKNOWN;
+            raise_failure(REASON_EMPTY_CASE);
+            schedule_next_case();
+            return;
         }
 
+        case_state = CASE_STATE_IDLE;
+        case_validation_count = 0;
+        case_timeout_occurred = false;
+        case_headroom_exceeded = false;
+        const repeat_t setup_repeat = case_control.repeat;
+        case_control = control_t();
+
         if (setup_repeat & REPEAT_SETUP_TEARDOWN) {
             location = LOCATION_CASE_SETUP;
-            if (handlers.case_setup && (handlers.case_setup(case_current, test_index_of_case) != STATUS_CONTINUE)) {
+            HeapTracker::snapshot_t heap;
+            HeapTracker::start(heap);
+            const uint64_t setup_start = utest_v1_get_time_ns();
+            const status_t setup_status = handlers.case_setup ? handlers.case_setup(case_current, test_index_of_case) : STATUS_CONTINUE;
+            add_elapsed(case_metrics.setup_ns, setup_start);
+            HeapTracker::stop(heap, case_metrics.setup_heap);
+            if (setup_status != STATUS_CONTINUE) {
                 raise_failure(REASON_CASE_SETUP);
                 schedule_next_case();
                 return;
             }
         }
 
-        case_failed_before = case_failed;
-        location = LOCATION_CASE_HANDLER;
+        // the handlers of the following overlappable test cases start their wait now
+        dispatch_pipelined_cases();
 
-        if (case_current->handler) {
-            case_current->handler();
-        } else if (case_current->control_handler) {
-            case_control = case_control + case_current->control_handler();
-        } else if (case_current->repeat_count_handler) {
-            case_control = case_control + case_current->repeat_count_handler(case_repeat_count);
-        }
-        case_repeat_count++;
+        bool repeat_handler;
+        do {
+            case_failed_before = case_failed;
+            location = LOCATION_CASE_HANDLER;
 
-        {
-            UTEST_ENTER_CRITICAL_SECTION;
-            if (case_validation_count) case_control.repeat = repeat_t(case_control.repeat & ~REPEAT_ON_TIMEOUT);
+            const bool crashed = !call_handler(call_case_handler, this, *case_current, case_metrics);
+            case_repeat_count++;
+
+            // an assertion in the case handler may have aborted the specification
+            if (test_cases == NULL) return;
+            raise_handler_failures(*case_current, crashed, case_metrics);
+            if (test_cases == NULL) return;
+
+            repeat_handler = false;
+            // an overlapped test case continues the wait that started when its handler was dispatched
+            const bool is_awaiting = case_pipelined && adopt_pipelined_wait();
+            if (!is_awaiting) case_wait_start = utest_v1_get_time_ns();
+            // the control of the test case is final, validations from now on may complete its wait.
+            // the exchange is a barrier, so either the harness counts a validation below or the validation sees the wait.
+            change_case_state(CASE_STATE_IDLE, CASE_STATE_STARTING);
+            const size_t required_validations = get_required_validations(case_control);
+            if (case_validation_count >= required_validations) case_control.repeat = repeat_t(case_control.repeat & ~REPEAT_ON_TIMEOUT);
 
             // if timeout valid
-            if (case_control.timeout < TIMEOUT_UNDECLR && case_validation_count == 0) {
+            if (case_control.timeout < TIMEOUT_UNDECLR && case_validation_count < required_validations) {
                 // if await validation _with_ timeout
-                if (case_control.timeout < TIMEOUT_FOREVER) {
-                    case_timeout_handle = scheduler.post(handle_timeout, case_control.timeout);
-                    if (case_timeout_handle == NULL) {
-                        raise_failure(REASON_SCHEDULER);
-                        schedule_next_case();
-                    }
+                if (case_control.timeout < TIMEOUT_FOREVER && !is_awaiting)
+                    case_timeout_handle = scheduler.post(handle_timeout, this, case_control.timeout);
+
+                if (case_control.timeout < TIMEOUT_FOREVER && case_timeout_handle == NULL) {
+                    case_state = CASE_STATE_IDLE;
+                    raise_failure(REASON_SCHEDULER);
+                    schedule_next_case();
+                }
+                // the validation completing the wait may have arrived while it started
+                else if (!change_case_state(CASE_STATE_STARTING, CASE_STATE_AWAITING)) {
+                    complete_wait();
                 }
             }
             else {
-                scheduler.post(schedule_next_case, 0);
+                case_state = CASE_STATE_IDLE;
+                if (!(case_control.repeat & REPEAT_SETUP_TEARDOWN) &&
+                     (case_control.repeat & (REPEAT_ON_TIMEOUT | REPEAT_ON_VALIDATE))) {
+                    // a synchronous repeat of only the handler is executed in place,
+                    // with the same accounting as `schedule_next_case()` followed by `run_next_case()`.
+                    // failures raised by other threads until now belong to this iteration.
+                    handle_events();
+                    if (test_cases == NULL) return;
+                    if (!case_timeout_occurred && case_failed_before == case_failed) case_passed++;
+                    case_validation_count = 0;
+                    case_timeout_occurred = false;
+                    case_control = control_t();
+                    repeat_handler = true;
+                }
+                else {
+                    post_step(&HarnessContext::schedule_next_case, schedule_next_case);
+                }
             }
-            UTEST_LEAVE_CRITICAL_SECTION;
+        } while (repeat_handler);
+    }
+    else {
+        const failure_t failure = test_failed ? failure_t(REASON_CASES, LOCATION_UNKNOWN) : failure_t(REASON_NONE);
+        if (handlers.test_teardown) {
+            location = LOCATION_TEST_TEARDOWN;
+            handlers.test_teardown(test_passed, test_failed, failure);
         }
+        finish(failure, test_failed);
     }
-    else if (handlers.test_teardown) {
-        location = LOCATION_TEST_TEARDOWN;
-        handlers.test_teardown(test_passed, test_failed, test_failed ? failure_t(REASON_CASES, LOCATION_UNKNOWN) : failure_t(REASON_NONE));
-        test_cases = NULL;
-        exit(test_failed);
-    } else {
-        exit(test_failed);
+}
+
+void HarnessContext::call_case_handler(void *context)
+{
+    static_cast<HarnessContext*>(context)->call_case_handler();
+}
+
+bool HarnessContext::call_handler(void (*function)(void*), void *context, const Case &source, case_metrics_t &metrics)
+{
+    HeapTracker::snapshot_t heap;
+    HeapTracker::start(heap);
+    if (perf_counters) perf_counters->start();
+    const uint64_t handler_start = utest_v1_get_time_ns();
+    // the watchdog of the test case overrides the one of the harness
+    const uint32_t watchdog_ms = source.get_watchdog() ? source.get_watchdog() : watchdog_timeout_ms;
+    if (watchdog_ms && crash_guard == NULL && UTEST_WATCHDOG_AVAILABLE) crash_guard = new CrashGuard();
+    bool crashed = false;
+    case_handler_allocations = 0;
+    if (crash_guard) crashed = !crash_guard->call(function, context, watchdog_ms);
+    else function(context);
+    add_elapsed(metrics.handler_ns, handler_start);
+    if (perf_counters) perf_counters->stop(metrics.perf_counts);
+    HeapTracker::stop(heap, metrics.handler_heap);
+    return !crashed;
+}
+
+void HarnessContext::raise_handler_failures(const Case &source, const bool crashed, case_metrics_t &metrics)
+{
+    if (crashed) {
+        crash_guard->print();
+        raise_failure(crash_guard->has_timed_out() ? REASON_TIMEOUT : REASON_CRASH);
+        if (test_cases == NULL) return;
+    }
+    if (case_handler_allocations && (source.get_attributes() & CASE_ATTRIBUTE_NO_ALLOCATION)) {
+        raise_failure(REASON_ALLOCATION);
+        if (test_cases == NULL) return;
+    }
+    if (stack_monitor) {
+        // the budget of a test case is only reported once, when it is first exceeded
+        const size_t budget = source.get_stack_budget();
+        const bool was_exceeded = budget && (metrics.stack_peak_bytes > budget);
+        const size_t peak = stack_monitor->get_peak();
+        if (peak > metrics.stack_peak_bytes) metrics.stack_peak_bytes = peak;
+        if (budget && !was_exceeded && metrics.stack_peak_bytes > budget)
+            raise_failure(REASON_STACK_BUDGET);
+    }
+}
+
+void HarnessContext::call_case_handler()
+{
+    // other threads may allocate at the same time, so only the allocations of this thread are checked
+    const uint64_t allocations = HeapTracker::get_thread_allocations();
+    if (case_current->handler) {
+        // the worker has already checked the allocations of a parallel test case
+        if (join_parallel_case()) return;
+        case_current->handler();
+    } else if (case_current->control_handler) {
+        // the handler of an overlapped test case has already been checked when it was dispatched
+        if (join_pipelined_case()) return;
+        case_control = case_control + case_current->control_handler();
+    } else if (case_current->repeat_count_handler) {
+        case_control = case_control + case_current->repeat_count_handler(case_repeat_count);
+    } else if (case_current->comparison_handler) {
+        case_control = case_control + run_comparison();
+    } else if (case_current->benchmark_handler) {
+        run_benchmark();
+    }
+    case_handler_allocations = HeapTracker::get_thread_allocations() - allocations;
+}
+
+// --- BENCHMARK TEST CASES ---
+size_t HarnessContext::calibrate_benchmark(const case_benchmark_handler_t handler)
+{
+    const uint64_t target_ns = uint64_t(UTEST_BENCHMARK_SAMPLE_US) * 1000;
+    // without a clock, every call seems to take no time, so the iterations would grow up to their limit
+    if (utest_v1_get_time_ns() == 0) {
+        raise_failure(REASON_NO_CLOCK);
+        return 0;
+    }
+
+    // an assertion in the benchmark handler stops the measurement
+    size_t iterations = 1;
+    for (size_t next = 1; next; ) {
+        iterations = next;
+        next = Benchmark::calibrate(iterations, Benchmark::measure(handler, iterations), target_ns);
+        if (test_cases == NULL || case_failed != case_failed_before) return 0;
     }
+    for (size_t ii = 0; ii < UTEST_BENCHMARK_WARMUP_SAMPLES; ii++) {
+        Benchmark::measure(handler, iterations);
+        if (test_cases == NULL || case_failed != case_failed_before) return 0;
+    }
+    return iterations;
+}
+
+void HarnessContext::run_benchmark()
+{
+    const case_benchmark_handler_t handler = case_current->benchmark_handler;
+    double sample_ns[UTEST_BENCHMARK_SAMPLES];
+
+    const size_t iterations = calibrate_benchmark(handler);
+    if (iterations == 0) return;
+    for (size_t ii = 0; ii < UTEST_BENCHMARK_SAMPLES; ii++) {
+        sample_ns[ii] = double(Benchmark::measure(handler, iterations)) / iterations;
+        if (test_cases == NULL || case_failed != case_failed_before) return;
+    }
+
+    const benchmark_result_t result = Benchmark::evaluate(sample_ns, UTEST_BENCHMARK_SAMPLES, iterations);
+    if (handlers.case_benchmark)
+        handlers.case_benchmark(case_current, result);
+
+    if (baseline) {
+        baseline->save(case_current->get_description(), result);
+        if (baseline->is_regression(case_current->get_description(), result))
+            raise_failure(REASON_PERF_REGRESSION);
+    }
+}
+
+control_t HarnessContext::run_comparison()
+{
+    const case_benchmark_handler_t baseline_handler = case_current->benchmark_handler;
+    const case_benchmark_handler_t candidate_handler = case_current->comparison_handler;
+
+    // the first call calibrates both handlers, every following call measures one block
+    if (case_repeat_count == 1) {
+        const size_t baseline_iterations = calibrate_benchmark(baseline_handler);
+        if (baseline_iterations == 0) return CaseNext;
+        const size_t candidate_iterations = calibrate_benchmark(candidate_handler);
+        if (candidate_iterations == 0) return CaseNext;
+
+        if (comparison == NULL) comparison = new BenchmarkComparison();
+        comparison->reset(baseline_iterations, candidate_iterations, uint32_t(utest_v1_get_time_ns()));
+        return CaseRepeatHandler;
+    }
+
+    comparison->measure(baseline_handler, candidate_handler);
+    if (test_cases == NULL || case_failed != case_failed_before) return CaseNext;
+    if (comparison->get_blocks() < UTEST_BENCHMARK_SAMPLES) return CaseRepeatHandler;
+
+    if (handlers.case_comparison)
+        handlers.case_comparison(case_current, comparison->evaluate());
+    return CaseNext;
+}
+
+// --- PARALLEL TEST CASES ---
+bool HarnessContext::is_parallel(const Case &test_case)
+{
+    return (test_case.get_attributes() & CASE_ATTRIBUTE_INDEPENDENT) && test_case.handler;
+}
+
+void HarnessContext::run_parallel_case(void *context, const size_t index)
+{
+    HarnessContext *self = static_cast<HarnessContext*>(context);
+    const Case &test_case = self->parallel_begin[index];
+    current_parallel_case = &self->parallel_cases[index];
+    const uint64_t allocations = HeapTracker::get_thread_allocations();
+    test_case.handler();
+    if (HeapTracker::get_thread_allocations() != allocations && (test_case.get_attributes() & CASE_ATTRIBUTE_NO_ALLOCATION))
+        self->parallel_cases[index].record(REASON_ALLOCATION);
+    current_parallel_case = NULL;
+}
+
+bool HarnessContext::join_parallel_case()
+{
+    if (workers == NULL || workers->get_workers() == 0 || !is_parallel(*case_current))
+        return false;
+
+    size_t index = case_current - parallel_begin;
+    // the current case may not be part of the executing batch, ie. if the teardown handler selected another case
+    if (parallel_cases == NULL || case_current < parallel_begin || index >= parallel_length || parallel_cases[index].is_joined)
+    {
+        release_parallel_cases();
+
+        // dispatch all consecutive independent test cases starting with the current one
+        size_t length = 1;
+        while ((case_current + length) < (test_cases + test_length) && is_parallel(case_current[length])) {
+            length++;
+        }
+        if (length < 2)
+            return false;
+
+        parallel_cases = new parallel_case_t[length]();
+        parallel_begin = case_current;
+        parallel_length = length;
+        if (!workers->dispatch(run_parallel_case, this, length)) {
+            release_parallel_cases();
+            return false;
+        }
+        index = 0;
+    }
+
+    workers->wait(index);
+    const parallel_case_t &result = parallel_cases[index];
+    parallel_cases[index].is_joined = true;
+
+    for (size_t ii = 0; ii < result.failure_count && test_cases != NULL; ii++) {
+        const size_t failure = (ii < UTEST_PARALLEL_CASE_FAILURES) ? ii : (UTEST_PARALLEL_CASE_FAILURES - 1);
+        raise_failure(result.failures[failure]);
+    }
+    return true;
+}
+
+void HarnessContext::release_parallel_cases()
+{
+    if (parallel_cases == NULL)
+        return;
+    workers->wait_all();
+    delete[] parallel_cases;
+    parallel_cases = NULL;
+    parallel_begin = NULL;
+    parallel_length = 0;
+}
+
+// --- PIPELINED TEST CASES ---
+bool HarnessContext::is_pipelined(const Case &test_case)
+{
+    return (test_case.get_attributes() & CASE_ATTRIBUTE_OVERLAPPABLE) && test_case.control_handler;
+}
+
+HarnessContext::pipelined_case_t *HarnessContext::find_pipelined_case(const Case *const source)
+{
+    if (pipelined_cases == NULL || source < pipelined_begin || source >= (pipelined_begin + pipelined_length))
+        return NULL;
+    pipelined_case_t *const pipelined = &pipelined_cases[source - pipelined_begin];
+    return pipelined->is_joined ? NULL : pipelined;
+}
+
+void HarnessContext::dispatch_pipelined_cases()
+{
+    if (pipeline_depth < 2 || !is_pipelined(*case_current))
+        return;
+    // the current case may already be part of the dispatched batch, or be repeated after it has been joined
+    if (pipelined_cases && case_current >= pipelined_begin && case_current < (pipelined_begin + pipelined_length))
+        return;
+
+    release_pipelined_cases();
+
+    size_t length = 1;
+    while (length < pipeline_depth && (case_current + length) < (test_cases + test_length) &&
+           is_pipelined(case_current[length])) {
+        length++;
+    }
+    if (length < 2)
+        return;
+
+    pipelined_cases = new pipelined_case_t[length]();
+    pipelined_begin = case_current;
+    pipelined_length = length;
+    // the stack is painted again for every handler, so keep the usage of the current test case so far
+    if (stack_monitor) measure_case_usage();
+
+    for (size_t ii = 0; ii < length; ii++) {
+        pipelined_case_t &pipelined = pipelined_cases[ii];
+        pipelined.context = this;
+        pipelined.source = &pipelined_begin[ii];
+        if (stack_monitor) stack_monitor->paint();
+
+        // the failures of the handler are recorded for its test case
+        pipelined_dispatch = &pipelined;
+        const bool crashed = !call_handler(call_pipelined_handler, &pipelined, *pipelined.source, pipelined.handler_metrics);
+        raise_handler_failures(*pipelined.source, crashed, pipelined.handler_metrics);
+        pipelined_dispatch = NULL;
+
+        const control_t control = pipelined.control;
+        if (control.timeout < TIMEOUT_UNDECLR && pipelined.validation_count < get_required_validations(control)) {
+            pipelined.wait_start = utest_v1_get_time_ns();
+            if (control.timeout < TIMEOUT_FOREVER) {
+                pipelined.timeout_handle = scheduler.post(handle_pipelined_timeout, &pipelined, control.timeout);
+                if (pipelined.timeout_handle == NULL) {
+                    // the test case then does not wait at all
+                    pipelined.record(REASON_SCHEDULER);
+                    pipelined.control.timeout = TIMEOUT_NONE;
+                }
+            }
+        }
+    }
+    // the usage of the dispatched handlers is part of their own metrics
+    if (stack_monitor) stack_monitor->paint();
+}
+
+void HarnessContext::call_pipelined_handler(void *context)
+{
+    pipelined_case_t *const pipelined = static_cast<pipelined_case_t*>(context);
+    const uint64_t allocations = HeapTracker::get_thread_allocations();
+    pipelined->control = pipelined->source->control_handler();
+    pipelined->context->case_handler_allocations = HeapTracker::get_thread_allocations() - allocations;
+}
+
+bool HarnessContext::join_pipelined_case()
+{
+    pipelined_case_t *const pipelined = find_pipelined_case(case_current);
+    if (pipelined == NULL)
+        return false;
+
+    for (size_t ii = 0; ii < pipelined->failure_count && test_cases != NULL; ii++) {
+        const size_t failure = (ii < UTEST_PARALLEL_CASE_FAILURES) ? ii : (UTEST_PARALLEL_CASE_FAILURES - 1);
+        raise_failure(pipelined->failures[failure]);
+    }
+    add_handler_metrics(case_metrics, pipelined->handler_metrics);
+    case_control = case_control + pipelined->control;
+
+    // a timed out wait does not change anymore, all other waits are adopted once the handler returned
+    const bool timeout_occurred = pipelined->timeout_occurred;
+    if (timeout_occurred) pipelined->is_joined = true;
+    else case_pipelined = pipelined;
+    if (timeout_occurred) {
+        case_timeout_occurred = true;
+        case_metrics.wait_ns += pipelined->wait_ns;
+        add_latencies(case_metrics, pipelined->latencies);
+        case_control.timeout = TIMEOUT_NONE;
+        if (test_cases != NULL)
+            raise_failure(failure_reason_t(REASON_TIMEOUT | ((case_control.repeat & REPEAT_ON_TIMEOUT) ? REASON_IGNORE : 0)));
+    }
+    return true;
+}
+
+bool HarnessContext::adopt_pipelined_wait()
+{
+    // validations addressed to the overlapped case are counted towards the current case from now on
+    pipelined_case_t *const pipelined = case_pipelined;
+    case_pipelined = NULL;
+    pipelined->is_joined = true;
+    atomic_add(case_validation_count, pipelined->validation_count);
+    add_latencies(case_metrics, pipelined->latencies);
+    if (pipelined->headroom_exceeded) case_headroom_exceeded = true;
+
+    if (pipelined->is_validated) {
+        case_metrics.wait_ns += pipelined->wait_ns;
+        control_t merged_control = case_control + pipelined->validated_control;
+        case_control.repeat = repeat_t(merged_control.repeat & ~REPEAT_ON_TIMEOUT);
+        case_control.timeout = TIMEOUT_NONE;
+        return false;
+    }
+    if (pipelined->timeout_handle != NULL ||
+        (pipelined->control.timeout == TIMEOUT_FOREVER && pipelined->validation_count < get_required_validations(pipelined->control))) {
+        // the timeout of the overlapped case now times out the current case
+        case_timeout_handle = pipelined->timeout_handle;
+        case_wait_start = pipelined->wait_start;
+        return true;
+    }
+    return false;
+}
+
+void HarnessContext::handle_pipelined_timeout(void *context)
+{
+    pipelined_case_t *const pipelined = static_cast<pipelined_case_t*>(context);
+    if (pipelined->is_joined) {
+        handle_timeout(pipelined->context);
+    }
+    else if (pipelined->timeout_handle != NULL) {
+        pipelined->timeout_handle = NULL;
+        pipelined->timeout_occurred = true;
+        pipelined->wait_ns = utest_v1_get_time_ns() - pipelined->wait_start;
+    }
+}
+
+void HarnessContext::release_pipelined_cases()
+{
+    if (pipelined_cases == NULL)
+        return;
+    // the timeouts of joined test cases belong to the harness
+    for (size_t ii = 0; ii < pipelined_length; ii++) {
+        if (!pipelined_cases[ii].is_joined && pipelined_cases[ii].timeout_handle != NULL)
+            scheduler.cancel(pipelined_cases[ii].timeout_handle);
+    }
+    delete[] pipelined_cases;
+    pipelined_cases = NULL;
+    pipelined_begin = NULL;
+    pipelined_length = 0;
+    case_pipelined = NULL;
+}
+
+// --- ISOLATED TEST CASES ---
+bool HarnessContext::run_isolated_case()
+{
+    if (processes->is_forked())
+        return false;
+
+    isolated_case_job_t job = {case_index, test_index_of_case, test_passed, test_failed};
+    // the pool is refilled while the test case executes
+    if (!processes->prefork(isolation_processes, &job, sizeof(job)) ||
+        !processes->dispatch(&job, sizeof(job)) ||
+        !processes->prefork(isolation_processes, &job, sizeof(job)))
+    {
+        if (!processes->is_forked()) {
+            // no process could be forked, so the test case executes in this process
+            return false;
+        }
+        // this process was forked for an earlier test case, so continue with the current run state
+        case_index = job.case_index;
+        case_current = &test_cases[case_index];
+        test_index_of_case = job.test_index_of_case;
+        test_passed = job.test_passed;
+        test_failed = job.test_failed;
+        // the worker threads have not been forked along
+        workers = NULL;
+        parallel_cases = NULL;
+        if (perf_counters) perf_counters->open();
+        scheduler.init();
+        return false;
+    }
+
+    const uint64_t handler_start = utest_v1_get_time_ns();
+    isolated_case_result_t result;
+    const ProcessPool::status_t status = processes->wait(&result, sizeof(result), isolation_timeout_ms);
+    if (status == ProcessPool::STATUS_OK) {
+        case_index = result.case_index;
+        case_passed = result.case_passed;
+        case_failed = result.case_failed;
+        case_metrics = result.case_metrics;
+    }
+    else {
+        // the test case did not finish, so report the failure and teardown in its place
+        if (status == ProcessPool::STATUS_CRASHED) processes->print();
+        add_elapsed(case_metrics.handler_ns, handler_start);
+        handlers.case_teardown = defaults.get_handler(case_current->teardown_handler);
+        handlers.case_failure  = defaults.get_handler(case_current->failure_handler);
+        const failure_t failure((status == ProcessPool::STATUS_TIMEOUT) ? REASON_TIMEOUT : REASON_CASE_HANDLER, LOCATION_CASE_HANDLER);
+        location = LOCATION_CASE_HANDLER;
+
+        status_t fail_status = STATUS_ABORT;
+        call_test_failure(failure);
+        if (handlers.case_failure) fail_status = handlers.case_failure(case_current, failure);
+        if (fail_status != STATUS_IGNORE) case_failed++;
+
+        location = LOCATION_CASE_TEARDOWN;
+        if (handlers.case_teardown) {
+            HeapTracker::snapshot_t heap;
+            HeapTracker::start(heap);
+            const uint64_t teardown_start = utest_v1_get_time_ns();
+            status_t teardown_status = handlers.case_teardown(case_current, case_passed, case_failed, failure);
+            add_elapsed(case_metrics.teardown_ns, teardown_start);
+            HeapTracker::stop(heap, case_metrics.teardown_heap);
+            if (teardown_status < STATUS_CONTINUE) raise_failure(REASON_CASE_TEARDOWN);
+            else if (teardown_status > signed(test_length)) raise_failure(REASON_CASE_INDEX);
+            else if (teardown_status >= 0) case_index = teardown_status - 1;
+            if (test_cases == NULL) return true;
+        }
+    }
+    next_case();
+    post_step(&HarnessContext::run_next_case, run_next_case);
+    return true;
+}
+
+void HarnessContext::report_isolated_case()
+{
+    measure_case_usage();
+    const isolated_case_result_t result = {case_index, case_passed, case_failed, case_metrics};
+    processes->report(&result, sizeof(result));
+}
+
+// --- STATIC HARNESS INTERFACE ---
+bool Harness::set_scheduler(const utest_v1_scheduler_t scheduler)
+{
+    return HarnessContext::get_default().set_scheduler(scheduler);
+}
+
+bool Harness::set_scheduler(const utest_v1_scheduler_v2_t scheduler)
+{
+    return HarnessContext::get_default().set_scheduler(scheduler);
+}
+
+bool Harness::set_workers(const size_t count)
+{
+    return HarnessContext::get_default().set_workers(count);
+}
+
+bool Harness::set_pipelining(const size_t depth)
+{
+    return HarnessContext::get_default().set_pipelining(depth);
+}
+
+bool Harness::set_isolation(const size_t processes, const uint32_t timeout_ms)
+{
+    return HarnessContext::get_default().set_isolation(processes, timeout_ms);
+}
+
+bool Harness::set_baseline(const char *load_path, const char *save_path)
+{
+    return HarnessContext::get_default().set_baseline(load_path, save_path);
+}
+
+bool Harness::set_perf_counters(const bool enable)
+{
+    return HarnessContext::get_default().set_perf_counters(enable);
+}
+
+bool Harness::set_stack_monitor(const size_t size)
+{
+    return HarnessContext::get_default().set_stack_monitor(size);
+}
+
+bool Harness::set_stack_monitor(void *base, const size_t size)
+{
+    return HarnessContext::get_default().set_stack_monitor(base, size);
+}
+
+bool Harness::set_arena(const size_t size, const bool huge_pages)
+{
+    return HarnessContext::get_default().set_arena(size, huge_pages);
+}
+
+void *Harness::allocate(const size_t size)
+{
+    return HarnessContext::get_current().allocate(size);
+}
+
+bool Harness::set_crash_guard(const bool enable)
+{
+    return HarnessContext::get_default().set_crash_guard(enable);
+}
+
+bool Harness::set_watchdog(const uint32_t timeout_ms)
+{
+    return HarnessContext::get_default().set_watchdog(timeout_ms);
+}
+
+bool Harness::serve(const Specification& specification, const char *path)
+{
+    return HarnessContext::get_default().serve(specification, path);
+}
+
+bool Harness::run(const Specification& specification, size_t)
+{
+    return run(specification);
+}
+
+bool Harness::run(const Specification& specification)
+{
+    return HarnessContext::get_default().run(specification);
+}
+
+void Harness::raise_failure(const failure_reason_t reason)
+{
+    HarnessContext::get_current().raise_failure(reason);
+}
+
+void Harness::raise_failure(const Case *const source, const failure_reason_t reason)
+{
+    HarnessContext::get_current().raise_failure(source, reason);
+}
+
+void Harness::validate_callback(const control_t control)
+{
+    HarnessContext::get_current().validate_callback(control);
+}
+
+void Harness::validate_callback(const Case *const source, const control_t control)
+{
+    HarnessContext::get_current().validate_callback(source, control);
+}
+
+const Case *Harness::get_current_case()
+{
+    return HarnessContext::get_current().get_current_case();
+}
+
+case_metrics_t Harness::get_case_metrics()
+{
+    return HarnessContext::get_current().get_case_metrics();
+}
+
+bool Harness::is_busy()
+{
+    return HarnessContext::get_current().is_busy();
 }
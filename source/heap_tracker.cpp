@@ -0,0 +1,187 @@
+/****************************************************************************
+ * Copyright (c) 2016, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ****************************************************************************
+ */
+
+#include "utest/heap_tracker.h"
+
+using namespace utest::v1;
+
+#if UTEST_HEAP_TRACKER_AVAILABLE
+
+#include <errno.h>
+#include <malloc.h>
+
+// the counters are updated by every thread of the process, they are only zero-initialized,
+// since allocations may happen before any constructor is executed
+static uint64_t heap_allocations;
+static uint64_t heap_bytes;
+static int64_t heap_live_bytes;
+static int64_t heap_live_blocks;
+static int64_t heap_peak_bytes;
+// the initial-exec model reads the counter without calling into the dynamic linker, which may allocate
+static __thread uint64_t heap_thread_allocations __attribute__((tls_model("initial-exec")));
+
+static void count_allocation(void *pointer)
+{
+    if (pointer == NULL) return;
+    const int64_t size = malloc_usable_size(pointer);
+    heap_thread_allocations++;
+    __sync_fetch_and_add(&heap_allocations, 1);
+    __sync_fetch_and_add(&heap_bytes, size);
+    __sync_fetch_and_add(&heap_live_blocks, 1);
+    const int64_t live = __sync_add_and_fetch(&heap_live_bytes, size);
+
+    int64_t peak = heap_peak_bytes;
+    while (live > peak) {
+        const int64_t previous = __sync_val_compare_and_swap(&heap_peak_bytes, peak, live);
+        if (previous == peak) break;
+        peak = previous;
+    }
+}
+
+static void count_free(void *pointer)
+{
+    if (pointer == NULL) return;
+    __sync_fetch_and_sub(&heap_live_bytes, int64_t(malloc_usable_size(pointer)));
+    __sync_fetch_and_sub(&heap_live_blocks, 1);
+}
+
+// the glibc allocator, which the interposed functions forward to
+extern "C" {
+    void *__libc_malloc(size_t size);
+    void *__libc_calloc(size_t count, size_t size);
+    void *__libc_realloc(void *pointer, size_t size);
+    void *__libc_memalign(size_t alignment, size_t size);
+    void *__libc_valloc(size_t size);
+    void *__libc_pvalloc(size_t size);
+    void __libc_free(void *pointer);
+}
+
+extern "C" void *malloc(size_t size)
+{
+    void *pointer = __libc_malloc(size);
+    count_allocation(pointer);
+    return pointer;
+}
+
+extern "C" void *calloc(size_t count, size_t size)
+{
+    void *pointer = __libc_calloc(count, size);
+    count_allocation(pointer);
+    return pointer;
+}
+
+extern "C" void *realloc(void *pointer, size_t size)
+{
+    const size_t previous_size = pointer ? malloc_usable_size(pointer) : 0;
+    void *reallocated = __libc_realloc(pointer, size);
+    // a failed reallocation keeps the previous block
+    if (reallocated == NULL && size) return NULL;
+    if (pointer) {
+        __sync_fetch_and_sub(&heap_live_bytes, int64_t(previous_size));
+        __sync_fetch_and_sub(&heap_live_blocks, 1);
+    }
+    count_allocation(reallocated);
+    return reallocated;
+}
+
+extern "C" void free(void *pointer)
+{
+    count_free(pointer);
+    __libc_free(pointer);
+}
+
+extern "C" void *memalign(size_t alignment, size_t size)
+{
+    void *pointer = __libc_memalign(alignment, size);
+    count_allocation(pointer);
+    return pointer;
+}
+
+extern "C" void *aligned_alloc(size_t alignment, size_t size)
+{
+    return memalign(alignment, size);
+}
+
+extern "C" int posix_memalign(void **result, size_t alignment, size_t size)
+{
+    if (alignment % sizeof(void*) || (alignment & (alignment - 1)))
+        return EINVAL;
+    void *pointer = memalign(alignment, size);
+    if (pointer == NULL && size)
+        return ENOMEM;
+    *result = pointer;
+    return 0;
+}
+
+extern "C" void *valloc(size_t size)
+{
+    void *pointer = __libc_valloc(size);
+    count_allocation(pointer);
+    return pointer;
+}
+
+extern "C" void *pvalloc(size_t size)
+{
+    void *pointer = __libc_pvalloc(size);
+    count_allocation(pointer);
+    return pointer;
+}
+
+void HeapTracker::start(snapshot_t &snapshot)
+{
+    snapshot.allocations = heap_allocations;
+    snapshot.bytes = heap_bytes;
+    snapshot.live_bytes = heap_live_bytes;
+    heap_peak_bytes = snapshot.live_bytes;
+}
+
+uint64_t HeapTracker::stop(const snapshot_t &snapshot, heap_metrics_t &metrics)
+{
+    const uint64_t allocations = heap_allocations - snapshot.allocations;
+    metrics.allocations += allocations;
+    metrics.bytes += heap_bytes - snapshot.bytes;
+    if (heap_peak_bytes > snapshot.live_bytes && uint64_t(heap_peak_bytes - snapshot.live_bytes) > metrics.peak_bytes)
+        metrics.peak_bytes = heap_peak_bytes - snapshot.live_bytes;
+    return allocations;
+}
+
+int64_t HeapTracker::get_live_bytes()
+{
+    return heap_live_bytes;
+}
+
+int64_t HeapTracker::get_live_blocks()
+{
+    return heap_live_blocks;
+}
+
+uint64_t HeapTracker::get_thread_allocations()
+{
+    return heap_thread_allocations;
+}
+
+#else
+
+// without interposing the allocator no allocation can be counted.
+void HeapTracker::start(snapshot_t &snapshot) { snapshot.allocations = snapshot.bytes = 0; snapshot.live_bytes = 0; }
+uint64_t HeapTracker::stop(const snapshot_t &, heap_metrics_t &) { return 0; }
+int64_t HeapTracker::get_live_bytes() { return 0; }
+int64_t HeapTracker::get_live_blocks() { return 0; }
+uint64_t HeapTracker::get_thread_allocations() { return 0; }
+
+#endif
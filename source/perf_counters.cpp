@@ -0,0 +1,143 @@
+/****************************************************************************
+ * Copyright (c) 2016, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ****************************************************************************
+ */
+
+#include "utest/perf_counters.h"
+
+using namespace utest::v1;
+
+#if UTEST_PERF_COUNTERS_AVAILABLE
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+// the type and config of every `perf_counter_t`
+static const struct {
+    uint32_t type;
+    uint64_t config;
+} perf_events[PERF_COUNTER_COUNT] = {
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES}
+};
+
+static int open_event(const size_t counter, const int group_fd)
+{
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = perf_events[counter].type;
+    attr.config = perf_events[counter].config;
+    attr.read_format = PERF_FORMAT_GROUP;
+    attr.exclude_hv = 1;
+
+    // count the kernel too, if `perf_event_paranoid` permits it
+    int fd = syscall(__NR_perf_event_open, &attr, 0, -1, group_fd, 0);
+    if (fd < 0 && (errno == EACCES || errno == EPERM)) {
+        attr.exclude_kernel = 1;
+        fd = syscall(__NR_perf_event_open, &attr, 0, -1, group_fd, 0);
+    }
+    return fd;
+}
+
+PerfCounters::PerfCounters() :
+    count(0)
+{
+    for (size_t ii = 0; ii < PERF_COUNTER_COUNT; ii++) {
+        fds[ii] = -1;
+        started[ii] = 0;
+    }
+}
+
+PerfCounters::~PerfCounters()
+{
+    close();
+}
+
+bool PerfCounters::open()
+{
+    close();
+    // the first counter that can be opened leads the group
+    int leader = -1;
+    for (size_t ii = 0; ii < PERF_COUNTER_COUNT; ii++) {
+        fds[ii] = open_event(ii, leader);
+        if (fds[ii] < 0) continue;
+        if (leader < 0) leader = fds[ii];
+        slots[ii] = count++;
+    }
+    return (count > 0);
+}
+
+void PerfCounters::close()
+{
+    // the group leader is closed last
+    for (size_t ii = PERF_COUNTER_COUNT; ii > 0; ii--) {
+        if (fds[ii - 1] >= 0) ::close(fds[ii - 1]);
+        fds[ii - 1] = -1;
+    }
+    count = 0;
+}
+
+bool PerfCounters::read_counts(uint64_t *counts) const
+{
+    // the group is read as the number of counters followed by their values
+    uint64_t values[1 + PERF_COUNTER_COUNT];
+    if (count == 0) return false;
+    for (size_t ii = 0; ii < PERF_COUNTER_COUNT; ii++) {
+        if (fds[ii] >= 0) {
+            const ssize_t size = read(fds[ii], values, sizeof(values));
+            if (size < ssize_t(sizeof(uint64_t) * (1 + count))) return false;
+            break;
+        }
+    }
+    for (size_t ii = 0; ii < PERF_COUNTER_COUNT; ii++)
+        counts[ii] = (fds[ii] >= 0) ? values[1 + slots[ii]] : 0;
+    return true;
+}
+
+void PerfCounters::start()
+{
+    if (!read_counts(started)) {
+        for (size_t ii = 0; ii < PERF_COUNTER_COUNT; ii++) started[ii] = 0;
+    }
+}
+
+void PerfCounters::stop(uint64_t *counts)
+{
+    uint64_t stopped[PERF_COUNTER_COUNT];
+    if (!read_counts(stopped)) return;
+    for (size_t ii = 0; ii < PERF_COUNTER_COUNT; ii++)
+        counts[ii] += stopped[ii] - started[ii];
+}
+
+#else
+
+// without `perf_event_open()` no counter can be opened, so all counts stay zero.
+PerfCounters::PerfCounters() : count(0) {}
+PerfCounters::~PerfCounters() {}
+bool PerfCounters::open() { return false; }
+void PerfCounters::close() {}
+bool PerfCounters::read_counts(uint64_t *) const { return false; }
+void PerfCounters::start() {}
+void PerfCounters::stop(uint64_t *) {}
+
+#endif
@@ -0,0 +1,230 @@
+/****************************************************************************
+ * Copyright (c) 2016, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ****************************************************************************
+ */
+
+#include "utest/process_pool.h"
+
+using namespace utest::v1;
+
+#if UTEST_PROCESS_POOL_AVAILABLE
+
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+
+#ifndef MSG_NOSIGNAL
+#   define MSG_NOSIGNAL 0
+#endif
+
+// writing to a crashed process must not raise SIGPIPE in the parent
+static bool send_all(const int fd, const void *buffer, size_t size)
+{
+    const char *data = static_cast<const char*>(buffer);
+    while (size) {
+        const ssize_t count = send(fd, data, size, MSG_NOSIGNAL);
+        if (count < 0 && errno == EINTR) continue;
+        if (count <= 0) return false;
+        data += count;
+        size -= count;
+    }
+    return true;
+}
+
+static bool receive_all(const int fd, void *buffer, size_t size)
+{
+    char *data = static_cast<char*>(buffer);
+    while (size) {
+        const ssize_t count = recv(fd, data, size, 0);
+        if (count < 0 && errno == EINTR) continue;
+        if (count <= 0) return false;
+        data += count;
+        size -= count;
+    }
+    return true;
+}
+
+static int wait_for(const int pid)
+{
+    int status = 0;
+    while (waitpid(pid, &status, 0) < 0 && errno == EINTR) ;
+    return status;
+}
+
+ProcessPool::ProcessPool() :
+    idle_count(0), parent_fd(-1), last_signal(0)
+{
+    executing.pid = 0;
+    executing.fd = -1;
+}
+
+ProcessPool::~ProcessPool()
+{
+    stop();
+}
+
+bool ProcessPool::prefork(size_t count, void *job, const size_t size)
+{
+    if (is_forked()) return true;
+    if (count > UTEST_PROCESS_POOL_SIZE) count = UTEST_PROCESS_POOL_SIZE;
+
+    while (idle_count < count)
+    {
+        int fds[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) return true;
+#ifdef SO_NOSIGPIPE
+        const int enable = 1;
+        setsockopt(fds[0], SOL_SOCKET, SO_NOSIGPIPE, &enable, sizeof(enable));
+#endif
+        // otherwise buffered output is written by both processes
+        fflush(NULL);
+
+        const int pid = fork();
+        if (pid < 0) {
+            close(fds[0]);
+            close(fds[1]);
+            return true;
+        }
+        if (pid == 0) {
+            // the other processes must see the end-of-file of their socket, when the parent closes it
+            for (size_t ii = 0; ii < idle_count; ii++) close(idle[ii].fd);
+            if (executing.pid) close(executing.fd);
+            idle_count = 0;
+            executing.pid = 0;
+            close(fds[0]);
+
+            // the parent closing the socket means we are no longer needed
+            if (!receive_all(fds[1], job, size)) _exit(0);
+            parent_fd = fds[1];
+            // keep the output of the job, even if it crashes
+            setvbuf(stdout, NULL, _IOLBF, BUFSIZ);
+            return false;
+        }
+        close(fds[1]);
+        idle[idle_count].pid = pid;
+        idle[idle_count].fd = fds[0];
+        idle_count++;
+    }
+    return true;
+}
+
+bool ProcessPool::dispatch(const void *job, const size_t size)
+{
+    if (executing.pid || idle_count == 0) return false;
+
+    process_t process = idle[--idle_count];
+    // the output of the parent must appear before the output of the job
+    fflush(NULL);
+    if (!send_all(process.fd, job, size)) {
+        close_process(process, true);
+        return false;
+    }
+    executing = process;
+    last_signal = 0;
+    return true;
+}
+
+ProcessPool::status_t ProcessPool::wait(void *result, const size_t size, const uint32_t timeout_ms)
+{
+    if (executing.pid == 0) return STATUS_ERROR;
+
+    struct pollfd poll_fd;
+    poll_fd.fd = executing.fd;
+    poll_fd.events = POLLIN;
+    int ready;
+    do {
+        ready = poll(&poll_fd, 1, timeout_ms ? int(timeout_ms) : -1);
+    } while (ready < 0 && errno == EINTR);
+
+    status_t status = STATUS_CRASHED;
+    if (ready == 0) {
+        status = STATUS_TIMEOUT;
+        kill(executing.pid, SIGKILL);
+    }
+    else if (ready > 0 && receive_all(executing.fd, result, size)) {
+        status = STATUS_OK;
+    }
+
+    close(executing.fd);
+    const int exit_status = wait_for(executing.pid);
+    if (status == STATUS_CRASHED && WIFSIGNALED(exit_status)) last_signal = WTERMSIG(exit_status);
+    executing.pid = 0;
+    executing.fd = -1;
+    return status;
+}
+
+void ProcessPool::report(const void *result, const size_t size)
+{
+    if (!is_forked()) return;
+    fflush(NULL);
+    send_all(parent_fd, result, size);
+    // the parent continues, so skip all exit handlers
+    _exit(0);
+}
+
+bool ProcessPool::is_forked() const
+{
+    return (parent_fd >= 0);
+}
+
+int ProcessPool::get_signal() const
+{
+    return last_signal;
+}
+
+void ProcessPool::print() const
+{
+    if (last_signal) printf(">>> process crashed with signal %d (%s)\n", last_signal, strsignal(last_signal));
+}
+
+void ProcessPool::close_process(process_t &process, const bool terminate)
+{
+    close(process.fd);
+    if (terminate) kill(process.pid, SIGKILL);
+    wait_for(process.pid);
+    process.pid = 0;
+    process.fd = -1;
+}
+
+void ProcessPool::stop()
+{
+    if (is_forked()) return;
+    // idle processes terminate when their socket is closed
+    while (idle_count) close_process(idle[--idle_count], false);
+    if (executing.pid) close_process(executing, true);
+}
+
+#else
+
+// without `fork()` no process can be started, so all jobs execute in the calling process.
+ProcessPool::ProcessPool() : idle_count(0), parent_fd(-1), last_signal(0) { executing.pid = 0; executing.fd = -1; }
+ProcessPool::~ProcessPool() {}
+bool ProcessPool::prefork(size_t, void *, const size_t) { return true; }
+bool ProcessPool::dispatch(const void *, const size_t) { return false; }
+ProcessPool::status_t ProcessPool::wait(void *, const size_t, const uint32_t) { return STATUS_ERROR; }
+void ProcessPool::report(const void *, const size_t) {}
+bool ProcessPool::is_forked() const { return false; }
+int ProcessPool::get_signal() const { return 0; }
+void ProcessPool::print() const {}
+void ProcessPool::close_process(process_t &, const bool) {}
+void ProcessPool::stop() {}
+
+#endif
@@ -0,0 +1,198 @@
+/****************************************************************************
+ * Copyright (c) 2016, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ****************************************************************************
+ */
+
+#include "utest/scheduler.h"
+#include "utest/shim.h"
+
+namespace
+{
+    // each pending callback of the adapted scheduler occupies one slot with its own trampoline
+    struct adapter_slot_t
+    {
+        utest_v1_harness_callback_v2_t callback;
+        void *context;
+        void *handle;
+        uint32_t generation;
+        bool is_pending;    ///< the trampoline is posted, so the slot must not be reused until it executed
+    };
+
+    utest_v1_scheduler_t adapted_scheduler = {NULL, NULL, NULL, NULL};
+    adapter_slot_t adapter_slots[UTEST_SCHEDULER_ADAPTER_SLOTS];
+}
+
+template< size_t N >
+static void utest_adapter_trampoline()
+{
+    utest_v1_harness_callback_v2_t callback;
+    void *context;
+    {
+        UTEST_ENTER_CRITICAL_SECTION;
+        callback = adapter_slots[N].callback;
+        context = adapter_slots[N].context;
+        adapter_slots[N].callback = NULL;
+        adapter_slots[N].generation++;
+        adapter_slots[N].is_pending = false;
+        UTEST_LEAVE_CRITICAL_SECTION;
+    }
+    // the callback may have been canceled, but the scheduler failed to do so
+    if (callback) callback(context);
+}
+
+// recursively instantiates one trampoline per slot
+template< size_t N >
+struct utest_adapter_trampolines
+{
+    static utest_v1_harness_callback_t get(const size_t index) {
+        return (index == N - 1) ? utest_adapter_trampoline< N - 1 > : utest_adapter_trampolines< N - 1 >::get(index);
+    }
+};
+template<>
+struct utest_adapter_trampolines< 0 >
+{
+    static utest_v1_harness_callback_t get(const size_t) {
+        return NULL;
+    }
+};
+
+// the handle stores the slot index in the lower 8 bits and the slot generation above.
+typedef char utest_adapter_slots_must_fit_into_8_bits[(UTEST_SCHEDULER_ADAPTER_SLOTS < 256) ? 1 : -1];
+
+static utest_v1_scheduler_handle_t utest_adapter_handle(const size_t index)
+{
+    return (utest_v1_scheduler_handle_t)((uintptr_t(adapter_slots[index].generation) << 8) | (index + 1));
+}
+
+static int32_t utest_adapter_init()
+{
+    {
+        UTEST_ENTER_CRITICAL_SECTION;
+        // initializing the adapted scheduler drops all posted trampolines, so every slot is free again
+        for (size_t ii = 0; ii < UTEST_SCHEDULER_ADAPTER_SLOTS; ii++) {
+            if (adapter_slots[ii].callback || adapter_slots[ii].is_pending) adapter_slots[ii].generation++;
+            adapter_slots[ii].callback = NULL;
+            adapter_slots[ii].handle = NULL;
+            adapter_slots[ii].is_pending = false;
+        }
+        UTEST_LEAVE_CRITICAL_SECTION;
+    }
+    return adapted_scheduler.init();
+}
+static utest_v1_scheduler_handle_t utest_adapter_post(const utest_v1_harness_callback_v2_t callback, void *context, const uint32_t delay_ms)
+{
+    if (callback == NULL) return NULL;
+
+    size_t index = UTEST_SCHEDULER_ADAPTER_SLOTS;
+    {
+        UTEST_ENTER_CRITICAL_SECTION;
+        for (size_t ii = 0; ii < UTEST_SCHEDULER_ADAPTER_SLOTS; ii++) {
+            if (!adapter_slots[ii].is_pending) {
+                adapter_slots[ii].callback = callback;
+                adapter_slots[ii].context = context;
+                adapter_slots[ii].handle = NULL;
+                adapter_slots[ii].is_pending = true;
+                index = ii;
+                break;
+            }
+        }
+        UTEST_LEAVE_CRITICAL_SECTION;
+    }
+    if (index == UTEST_SCHEDULER_ADAPTER_SLOTS) return NULL;
+
+    utest_v1_scheduler_handle_t handle = utest_adapter_handle(index);
+    void *adapted_handle = adapted_scheduler.post(utest_adapter_trampolines< UTEST_SCHEDULER_ADAPTER_SLOTS >::get(index), delay_ms);
+    {
+        UTEST_ENTER_CRITICAL_SECTION;
+        if (adapted_handle == NULL) {
+            adapter_slots[index].callback = NULL;
+            adapter_slots[index].generation++;
+            adapter_slots[index].is_pending = false;
+            handle = NULL;
+        }
+        // the callback may already have been executed by another thread
+        else if (handle == utest_adapter_handle(index)) {
+            adapter_slots[index].handle = adapted_handle;
+        }
+        UTEST_LEAVE_CRITICAL_SECTION;
+    }
+    return handle;
+}
+static int32_t utest_adapter_cancel(utest_v1_scheduler_handle_t handle)
+{
+    const uintptr_t value = uintptr_t(handle);
+    const size_t index = (value & 0xff) - 1;
+    if (index >= UTEST_SCHEDULER_ADAPTER_SLOTS) return -1;
+
+    void *adapted_handle = NULL;
+    uint32_t generation = 0;
+    {
+        UTEST_ENTER_CRITICAL_SECTION;
+        if (adapter_slots[index].callback && handle == utest_adapter_handle(index)) {
+            adapted_handle = adapter_slots[index].handle;
+            adapter_slots[index].callback = NULL;
+            generation = ++adapter_slots[index].generation;
+        }
+        UTEST_LEAVE_CRITICAL_SECTION;
+    }
+    if (adapted_handle == NULL) return -1;
+    // if the adapted scheduler cannot cancel, the trampoline still executes, but without the callback.
+    // the slot then stays reserved until then, so that the trampoline cannot execute a later callback early.
+    if (adapted_scheduler.cancel(adapted_handle) == 0) {
+        UTEST_ENTER_CRITICAL_SECTION;
+        // unless the trampoline executed in the meantime and the slot has been reused
+        if (adapter_slots[index].generation == generation) adapter_slots[index].is_pending = false;
+        UTEST_LEAVE_CRITICAL_SECTION;
+    }
+    return 0;
+}
+static size_t utest_adapter_post_batch(utest_v1_scheduler_post_t *const posts, const size_t count)
+{
+    for (size_t ii = 0; ii < count; ii++) {
+        posts[ii].handle = utest_adapter_post(posts[ii].callback, posts[ii].context, posts[ii].delay_ms);
+        if (posts[ii].handle == NULL) return ii;
+    }
+    return count;
+}
+static int32_t utest_adapter_run()
+{
+    return adapted_scheduler.run();
+}
+
+extern "C" {
+static const utest_v1_scheduler_v2_t utest_v1_scheduler_adapter =
+{
+    UTEST_V1_SCHEDULER_VERSION_2,
+    utest_adapter_init,
+    utest_adapter_post,
+    utest_adapter_cancel,
+    utest_adapter_post_batch,
+    utest_adapter_run
+};
+utest_v1_scheduler_v2_t utest_v1_scheduler_adapt(const utest_v1_scheduler_t scheduler)
+{
+    adapted_scheduler = scheduler;
+    return utest_v1_scheduler_adapter;
+}
+size_t utest_v1_scheduler_post_each(const utest_v1_scheduler_v2_t *const scheduler, utest_v1_scheduler_post_t *const posts, const size_t count)
+{
+    for (size_t ii = 0; ii < count; ii++) {
+        posts[ii].handle = scheduler->post(posts[ii].callback, posts[ii].context, posts[ii].delay_ms);
+        if (posts[ii].handle == NULL) return ii;
+    }
+    return count;
+}
+}
@@ -20,6 +20,7 @@
 
 #if UTEST_SHIM_SCHEDULER_USE_MINAR
 #include "minar/minar.h"
+#include "core-util/FunctionPointer.h"
 
 static int32_t utest_minar_init()
 {
@@ -35,6 +36,24 @@ static int32_t utest_minar_cancel(void *handle)
     int32_t ret = minar::Scheduler::cancelCallback(handle);
     return ret;
 }
+static utest_v1_scheduler_handle_t utest_minar_post_v2(const utest_v1_harness_callback_v2_t callback, void *context, const uint32_t delay_ms)
+{
+    void *handle = minar::Scheduler::postCallback(mbed::util::FunctionPointer1<void, void*>(callback).bind(context))
+                        .delay(minar::milliseconds(delay_ms)).getHandle();
+    return (utest_v1_scheduler_handle_t) handle;
+}
+static int32_t utest_minar_cancel_v2(utest_v1_scheduler_handle_t handle)
+{
+    return utest_minar_cancel(handle);
+}
+static size_t utest_minar_post_batch(utest_v1_scheduler_post_t *const posts, const size_t count)
+{
+    for (size_t ii = 0; ii < count; ii++) {
+        posts[ii].handle = utest_minar_post_v2(posts[ii].callback, posts[ii].context, posts[ii].delay_ms);
+        if (posts[ii].handle == NULL) return ii;
+    }
+    return count;
+}
 static int32_t utest_minar_run()
 {
     return 0;
@@ -47,10 +66,23 @@ static const utest_v1_scheduler_t utest_v1_scheduler =
     utest_minar_cancel,
     utest_minar_run
 };
+static const utest_v1_scheduler_v2_t utest_v1_scheduler_v2 =
+{
+    UTEST_V1_SCHEDULER_VERSION_2,
+    utest_minar_init,
+    utest_minar_post_v2,
+    utest_minar_cancel_v2,
+    utest_minar_post_batch,
+    utest_minar_run
+};
 utest_v1_scheduler_t utest_v1_get_scheduler()
 {
     return utest_v1_scheduler;
 }
+utest_v1_scheduler_v2_t utest_v1_get_scheduler_v2()
+{
+    return utest_v1_scheduler_v2;
+}
 }
 
 #elif UTEST_SHIM_SCHEDULER_USE_US_TICKER
@@ -59,60 +91,118 @@ utest_v1_scheduler_t utest_v1_get_scheduler()
 #else
 #   include "us_ticker_api.h"
 #endif
-// only one callback is active at any given time
-static volatile utest_v1_harness_callback_t minimal_callback;
-static volatile utest_v1_harness_callback_t ticker_callback;
+#include "utest/timer_queue.h"
+
+#ifndef UTEST_SHIM_SCHEDULER_IDLE
+#   ifdef YOTTA_MBED_HAL_VERSION_STRING
+#       include "mbed-hal/sleep_api.h"
+#   else
+#       include "sleep_api.h"
+#   endif
+    /// called with interrupts disabled, must return on the next interrupt, even if it is masked (ie. `__WFI()`)
+#   define UTEST_SHIM_SCHEDULER_IDLE() sleep()
+#endif
+
+// all pending callbacks are ordered by their timestamp in microseconds.
+// the ticker event is always armed for the earliest callback in the future.
+static utest::v1::TimerQueue ticker_queue;
 static const ticker_data_t *ticker_data;
 static ticker_event_t ticker_event;
 
 static void ticker_handler(uint32_t)
 {
-    // printf("\t\t>>> Ticker callback fired for %p.\n", ticker_callback);
-    minimal_callback = ticker_callback;
+    // the run loop checks for expired callbacks, the interrupt only needs to occur.
+}
+
+// @note must be called inside a critical section.
+static void utest_us_ticker_arm()
+{
+    ticker_remove_event(ticker_data, &ticker_event);
+    if (ticker_queue.is_empty()) return;
+
+    const uint32_t timestamp = ticker_queue.get_next_timestamp();
+    // expired callbacks are picked up by the run loop without an interrupt
+    if (int32_t(timestamp - ticker_read(ticker_data)) > 0) {
+        ticker_insert_event(ticker_data, &ticker_event, timestamp, 0);
+    }
 }
 
 static int32_t utest_us_ticker_init()
 {
+    UTEST_ENTER_CRITICAL_SECTION;
     ticker_data = get_us_ticker_data();
     ticker_set_handler(ticker_data, ticker_handler);
+    ticker_remove_event(ticker_data, &ticker_event);
+    ticker_queue.clear();
+    UTEST_LEAVE_CRITICAL_SECTION;
     return 0;
 }
 static void *utest_us_ticker_post(const utest_v1_harness_callback_t callback, const uint32_t delay_ms)
 {
-    // printf("\t\t>>> Schedule %p with %ums delay => %p.\n", callback, (unsigned int)delay_ms, (void*)1);
-    if (delay_ms) {
-        ticker_callback = callback;
-        // fire the interrupt in 1000us * delay_ms
-        ticker_insert_event(ticker_data, &ticker_event, ticker_read(ticker_data) + delay_ms * 1000, 0);
-    } else {
-        minimal_callback = callback;
-    }
-
-    // return a bogus handle
-    return (void*)1;
+    UTEST_ENTER_CRITICAL_SECTION;
+    // fire the callback in 1000us * delay_ms
+    void *handle = ticker_queue.insert(callback, ticker_read(ticker_data) + delay_ms * 1000);
+    if (handle && delay_ms) utest_us_ticker_arm();
+    UTEST_LEAVE_CRITICAL_SECTION;
+    return handle;
 }
 static int32_t utest_us_ticker_cancel(void *handle)
 {
-    // printf("\t\t>>> Cancel %p => %u\n", handle, (unsigned int)0);
-    (void) handle;
-    ticker_remove_event(ticker_data, &ticker_event);
-    return 0;
+    int32_t ret = -1;
+    UTEST_ENTER_CRITICAL_SECTION;
+    if (ticker_queue.cancel(handle)) {
+        utest_us_ticker_arm();
+        ret = 0;
+    }
+    UTEST_LEAVE_CRITICAL_SECTION;
+    return ret;
+}
+static utest_v1_scheduler_handle_t utest_us_ticker_post_v2(const utest_v1_harness_callback_v2_t callback, void *context, const uint32_t delay_ms)
+{
+    UTEST_ENTER_CRITICAL_SECTION;
+    void *handle = ticker_queue.insert(callback, context, ticker_read(ticker_data) + delay_ms * 1000);
+    if (handle && delay_ms) utest_us_ticker_arm();
+    UTEST_LEAVE_CRITICAL_SECTION;
+    return (utest_v1_scheduler_handle_t) handle;
+}
+static int32_t utest_us_ticker_cancel_v2(utest_v1_scheduler_handle_t handle)
+{
+    return utest_us_ticker_cancel(handle);
+}
+static size_t utest_us_ticker_post_batch(utest_v1_scheduler_post_t *const posts, const size_t count)
+{
+    size_t ii;
+    UTEST_ENTER_CRITICAL_SECTION;
+    // all callbacks share the same reference time and the ticker is armed only once
+    const uint32_t now = ticker_read(ticker_data);
+    for (ii = 0; ii < count; ii++) {
+        posts[ii].handle = (utest_v1_scheduler_handle_t) ticker_queue.insert(posts[ii].callback, posts[ii].context, now + posts[ii].delay_ms * 1000);
+        if (posts[ii].handle == NULL) break;
+    }
+    utest_us_ticker_arm();
+    UTEST_LEAVE_CRITICAL_SECTION;
+    return ii;
 }
 static int32_t utest_us_ticker_run()
 {
     while(1)
     {
-        // check if a new callback has been set
-        if (minimal_callback)
+        utest::v1::TimerQueue::callback_t callback;
+        bool expired;
         {
-            // printf("\t\t>>> Firing callback %p\n", minimal_callback);
-            // copy the callback
-            utest_v1_harness_callback_t callback = minimal_callback;
-            // reset the shared callback
-            minimal_callback = NULL;
-            // execute the copied callback
-            callback();
+            UTEST_ENTER_CRITICAL_SECTION;
+            expired = ticker_queue.pop_expired(ticker_read(ticker_data), callback);
+            if (expired) {
+                utest_us_ticker_arm();
+            } else {
+                // sleep until the ticker or any other interrupt fires.
+                // checking and sleeping inside the critical section ensures we cannot miss a wakeup.
+                UTEST_SHIM_SCHEDULER_IDLE();
+            }
+            UTEST_LEAVE_CRITICAL_SECTION;
         }
+        // execute the callback outside of the critical section
+        if (expired) callback();
     }
     return 0;
 }
@@ -124,10 +214,388 @@ static const utest_v1_scheduler_t utest_v1_scheduler =
     utest_us_ticker_cancel,
     utest_us_ticker_run
 };
+static const utest_v1_scheduler_v2_t utest_v1_scheduler_v2 =
+{
+    UTEST_V1_SCHEDULER_VERSION_2,
+    utest_us_ticker_init,
+    utest_us_ticker_post_v2,
+    utest_us_ticker_cancel_v2,
+    utest_us_ticker_post_batch,
+    utest_us_ticker_run
+};
+utest_v1_scheduler_t utest_v1_get_scheduler()
+{
+    return utest_v1_scheduler;
+}
+utest_v1_scheduler_v2_t utest_v1_get_scheduler_v2()
+{
+    return utest_v1_scheduler_v2;
+}
+}
+
+#elif UTEST_SHIM_SCHEDULER_USE_POSIX
+#include <stdlib.h>
+#include <errno.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include "utest/timer_queue.h"
+
+// Every posted callback is kept in one of two lists:
+//  - callbacks without delay are queued in FIFO order and executed directly by the run loop,
+//  - callbacks with a delay own a timerfd, which is registered with the epoll instance.
+// The run loop sleeps in `epoll_wait` whenever there is nothing to execute.
+struct utest_posix_event_t
+{
+    utest::v1::TimerQueue::callback_t callback;
+    int timer_fd;
+    uint64_t sequence;  ///< identifies the timer in the epoll events, since a freed address may be reused
+    utest_posix_event_t *next;
+};
+
+static pthread_mutex_t posix_lock = PTHREAD_MUTEX_INITIALIZER;
+static int posix_epoll_fd = -1;
+// wakes up the run loop, if a callback is posted while it is sleeping
+static int posix_wakeup_fd = -1;
+static bool posix_sleeping;
+static utest_posix_event_t *posix_queue_head;
+static utest_posix_event_t *posix_queue_tail;
+static utest_posix_event_t *posix_timers;
+// the sequence number of the last timer, zero identifies the wakeup descriptor
+static uint64_t posix_sequence;
+
+// removes the timer with this sequence number from the timer list, returns `NULL` if it was not found.
+// @note must be called with the lock held.
+static utest_posix_event_t *utest_posix_unlink_timer(const uint64_t sequence)
+{
+    utest_posix_event_t *previous = NULL;
+    for (utest_posix_event_t *current = posix_timers; current; previous = current, current = current->next)
+    {
+        if (current->sequence == sequence) {
+            if (previous) previous->next = current->next;
+            else posix_timers = current->next;
+            return current;
+        }
+    }
+    return NULL;
+}
+
+// removes the event from the list, returns `false` if it was not found.
+// @note must be called with the lock held.
+static bool utest_posix_unlink(utest_posix_event_t **list, utest_posix_event_t *event, utest_posix_event_t **tail)
+{
+    utest_posix_event_t *previous = NULL;
+    for (utest_posix_event_t *current = *list; current; previous = current, current = current->next)
+    {
+        if (current == event) {
+            if (previous) previous->next = current->next;
+            else *list = current->next;
+            if (tail && *tail == current) *tail = previous;
+            return true;
+        }
+    }
+    return false;
+}
+
+static void utest_posix_free_list(utest_posix_event_t *list)
+{
+    while (list) {
+        utest_posix_event_t *next = list->next;
+        if (list->timer_fd >= 0) close(list->timer_fd);
+        free(list);
+        list = next;
+    }
+}
+
+static int32_t utest_posix_init()
+{
+    pthread_mutex_lock(&posix_lock);
+    // closing inherited descriptors after a `fork()` does not affect the parent's instance
+    if (posix_epoll_fd >= 0) close(posix_epoll_fd);
+    if (posix_wakeup_fd >= 0) close(posix_wakeup_fd);
+    utest_posix_free_list(posix_queue_head);
+    utest_posix_free_list(posix_timers);
+    posix_queue_head = posix_queue_tail = posix_timers = NULL;
+    posix_sleeping = false;
+
+    posix_epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    posix_wakeup_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+    int32_t ret = -1;
+    if (posix_epoll_fd >= 0 && posix_wakeup_fd >= 0)
+    {
+        struct epoll_event ev;
+        ev.events = EPOLLIN;
+        ev.data.u64 = 0;
+        ret = epoll_ctl(posix_epoll_fd, EPOLL_CTL_ADD, posix_wakeup_fd, &ev);
+    }
+    pthread_mutex_unlock(&posix_lock);
+    return ret;
+}
+static utest_posix_event_t *utest_posix_post_event(const utest::v1::TimerQueue::callback_t &callback, const uint32_t delay_ms)
+{
+    utest_posix_event_t *event = (utest_posix_event_t*) malloc(sizeof(utest_posix_event_t));
+    if (event == NULL) return NULL;
+    event->callback = callback;
+    event->timer_fd = -1;
+    event->sequence = 0;
+    event->next = NULL;
+
+    if (delay_ms)
+    {
+        event->timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+        if (event->timer_fd < 0) {
+            free(event);
+            return NULL;
+        }
+        struct itimerspec spec;
+        spec.it_interval.tv_sec = 0;
+        spec.it_interval.tv_nsec = 0;
+        spec.it_value.tv_sec = delay_ms / 1000;
+        spec.it_value.tv_nsec = (delay_ms % 1000) * 1000000;
+
+        pthread_mutex_lock(&posix_lock);
+        event->sequence = ++posix_sequence;
+        struct epoll_event ev;
+        ev.events = EPOLLIN;
+        ev.data.u64 = event->sequence;
+        if (timerfd_settime(event->timer_fd, 0, &spec, NULL) != 0 ||
+            epoll_ctl(posix_epoll_fd, EPOLL_CTL_ADD, event->timer_fd, &ev) != 0)
+        {
+            pthread_mutex_unlock(&posix_lock);
+            close(event->timer_fd);
+            free(event);
+            return NULL;
+        }
+        event->next = posix_timers;
+        posix_timers = event;
+        pthread_mutex_unlock(&posix_lock);
+    }
+    else {
+        pthread_mutex_lock(&posix_lock);
+        if (posix_queue_tail) posix_queue_tail->next = event;
+        else posix_queue_head = event;
+        posix_queue_tail = event;
+        // only another thread can post while the run loop is sleeping
+        const bool wakeup = posix_sleeping;
+        posix_sleeping = false;
+        pthread_mutex_unlock(&posix_lock);
+
+        if (wakeup) {
+            const uint64_t one = 1;
+            ssize_t written = write(posix_wakeup_fd, &one, sizeof(one));
+            (void) written;
+        }
+    }
+    return event;
+}
+static void *utest_posix_post(const utest_v1_harness_callback_t callback, const uint32_t delay_ms)
+{
+    if (callback == NULL) return NULL;
+    utest::v1::TimerQueue::callback_t entry = {callback, NULL, NULL};
+    return utest_posix_post_event(entry, delay_ms);
+}
+static utest_v1_scheduler_handle_t utest_posix_post_v2(const utest_v1_harness_callback_v2_t callback, void *context, const uint32_t delay_ms)
+{
+    if (callback == NULL) return NULL;
+    utest::v1::TimerQueue::callback_t entry = {NULL, callback, context};
+    return (utest_v1_scheduler_handle_t) utest_posix_post_event(entry, delay_ms);
+}
+static size_t utest_posix_post_batch(utest_v1_scheduler_post_t *const posts, const size_t count)
+{
+    for (size_t ii = 0; ii < count; ii++) {
+        posts[ii].handle = utest_posix_post_v2(posts[ii].callback, posts[ii].context, posts[ii].delay_ms);
+        if (posts[ii].handle == NULL) return ii;
+    }
+    return count;
+}
+static int32_t utest_posix_cancel(void *handle)
+{
+    utest_posix_event_t *event = (utest_posix_event_t*) handle;
+    if (event == NULL) return -1;
+
+    pthread_mutex_lock(&posix_lock);
+    // only dereference the handle, if it is still pending
+    bool found = utest_posix_unlink(&posix_timers, event, NULL) ||
+                 utest_posix_unlink(&posix_queue_head, event, &posix_queue_tail);
+    pthread_mutex_unlock(&posix_lock);
+
+    if (!found) return -1;
+    // closing the timerfd also removes it from the epoll instance
+    if (event->timer_fd >= 0) close(event->timer_fd);
+    free(event);
+    return 0;
+}
+static int32_t utest_posix_cancel_v2(utest_v1_scheduler_handle_t handle)
+{
+    return utest_posix_cancel(handle);
+}
+static int32_t utest_posix_run()
+{
+    struct epoll_event events[8];
+    while(1)
+    {
+        pthread_mutex_lock(&posix_lock);
+        utest_posix_event_t *event = posix_queue_head;
+        if (event) utest_posix_unlink(&posix_queue_head, event, &posix_queue_tail);
+        else posix_sleeping = true;
+        pthread_mutex_unlock(&posix_lock);
+
+        // execute all immediate callbacks before going to sleep
+        if (event) {
+            const utest::v1::TimerQueue::callback_t callback = event->callback;
+            free(event);
+            callback();
+            continue;
+        }
+
+        // block until the next timer expires or another thread posts a callback
+        int count = epoll_wait(posix_epoll_fd, events, sizeof(events) / sizeof(events[0]), -1);
+        pthread_mutex_lock(&posix_lock);
+        posix_sleeping = false;
+        pthread_mutex_unlock(&posix_lock);
+        if (count < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        for (int ii = 0; ii < count; ii++)
+        {
+            if (events[ii].data.u64 == 0) {
+                uint64_t value;
+                ssize_t read_bytes = read(posix_wakeup_fd, &value, sizeof(value));
+                (void) read_bytes;
+                continue;
+            }
+            // a previous callback may have canceled this event already, and posted another one at its address
+            pthread_mutex_lock(&posix_lock);
+            event = utest_posix_unlink_timer(events[ii].data.u64);
+            pthread_mutex_unlock(&posix_lock);
+            if (event == NULL) continue;
+
+            const utest::v1::TimerQueue::callback_t callback = event->callback;
+            close(event->timer_fd);
+            free(event);
+            callback();
+        }
+    }
+    return 0;
+}
+extern "C" {
+static const utest_v1_scheduler_t utest_v1_scheduler =
+{
+    utest_posix_init,
+    utest_posix_post,
+    utest_posix_cancel,
+    utest_posix_run
+};
+static const utest_v1_scheduler_v2_t utest_v1_scheduler_v2 =
+{
+    UTEST_V1_SCHEDULER_VERSION_2,
+    utest_posix_init,
+    utest_posix_post_v2,
+    utest_posix_cancel_v2,
+    utest_posix_post_batch,
+    utest_posix_run
+};
 utest_v1_scheduler_t utest_v1_get_scheduler()
 {
     return utest_v1_scheduler;
 }
+utest_v1_scheduler_v2_t utest_v1_get_scheduler_v2()
+{
+    return utest_v1_scheduler_v2;
+}
+}
+
+#else
+extern "C" {
+// the port provides a custom scheduler, which is adapted on demand
+utest_v1_scheduler_v2_t utest_v1_get_scheduler_v2()
+{
+    return utest_v1_scheduler_adapt(utest_v1_get_scheduler());
+}
+}
+#endif
+
+#if UTEST_SHIM_SCHEDULER_USE_POSIX && !defined(YOTTA_CORE_UTIL_VERSION_STRING)
+// the harness may be called from other threads, so the host needs real mutual exclusion
+static pthread_mutex_t posix_critical_section;
+static pthread_once_t posix_critical_section_once = PTHREAD_ONCE_INIT;
+
+static void utest_posix_critical_section_init()
+{
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    // failure handlers may raise further failures inside the critical section
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&posix_critical_section, &attr);
+    pthread_mutexattr_destroy(&attr);
+}
+
+void utest_v1_enter_critical_section(void)
+{
+    pthread_once(&posix_critical_section_once, utest_posix_critical_section_init);
+    pthread_mutex_lock(&posix_critical_section);
+}
+void utest_v1_leave_critical_section(void)
+{
+    pthread_mutex_unlock(&posix_critical_section);
+}
+#endif
+
+#if defined(UTEST_SHIM_GET_TIME_NS)
+uint64_t utest_v1_get_time_ns(void)
+{
+    return UTEST_SHIM_GET_TIME_NS();
+}
+
+#elif defined(__unix__) || defined(__APPLE__)
+#include <time.h>
+
+// the raw clock is not slewed by NTP, so short intervals are not stretched or shrunk while measuring them
+#ifdef CLOCK_MONOTONIC_RAW
+#   define UTEST_SHIM_CLOCK_ID CLOCK_MONOTONIC_RAW
+#else
+#   define UTEST_SHIM_CLOCK_ID CLOCK_MONOTONIC
+#endif
+
+uint64_t utest_v1_get_time_ns(void)
+{
+    struct timespec now;
+    if (clock_gettime(UTEST_SHIM_CLOCK_ID, &now) != 0) return 0;
+    return uint64_t(now.tv_sec) * 1000000000ull + uint64_t(now.tv_nsec);
+}
+
+#elif defined(__MBED__)
+#ifdef YOTTA_MBED_HAL_VERSION_STRING
+#   include "mbed-hal/us_ticker_api.h"
+#else
+#   include "us_ticker_api.h"
+#endif
+
+uint64_t utest_v1_get_time_ns(void)
+{
+    // extend the 32bit microsecond ticker, which overflows every 71 minutes
+    static uint32_t last_ticks = 0;
+    static uint64_t overflows = 0;
+    uint64_t ticks;
+    {
+        UTEST_ENTER_CRITICAL_SECTION;
+        const uint32_t now = us_ticker_read();
+        if (now < last_ticks) overflows += (1ull << 32);
+        last_ticks = now;
+        ticks = overflows + now;
+        UTEST_LEAVE_CRITICAL_SECTION;
+    }
+    return ticks * 1000;
+}
+
+#else
+uint64_t utest_v1_get_time_ns(void)
+{
+    return 0;
 }
 #endif
 
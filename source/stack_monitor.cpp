@@ -0,0 +1,165 @@
+/****************************************************************************
+ * Copyright (c) 2016, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ****************************************************************************
+ */
+
+#include "utest/stack_monitor.h"
+
+using namespace utest::v1;
+
+#if UTEST_ALTERNATE_STACK_AVAILABLE
+
+#include <ucontext.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+struct StackMonitor::contexts_t
+{
+    ucontext_t caller;
+    ucontext_t stack;
+};
+
+#else
+
+struct StackMonitor::contexts_t {};
+
+#endif
+
+// 0xA5 in every byte, which is neither a small number nor a likely address
+static const uintptr_t stack_pattern = (~uintptr_t(0) / 0xFF) * 0xA5;
+
+StackMonitor::StackMonitor() :
+    bottom(NULL), top(NULL), mapping(NULL), mapping_size(0), contexts(NULL), function(NULL), context(NULL), is_painted(false)
+{}
+
+StackMonitor::~StackMonitor()
+{
+    // `exit()` may destroy the monitor while executing on its stack, which is then left to the operating system
+    if (is_executing()) return;
+    release();
+    delete contexts;
+}
+
+void StackMonitor::attach(void *base, const size_t size)
+{
+    const uintptr_t align = sizeof(uintptr_t) - 1;
+    bottom = reinterpret_cast<uintptr_t*>((uintptr_t(base) + align) & ~align);
+    top = reinterpret_cast<uintptr_t*>((uintptr_t(base) + size) & ~align);
+    is_painted = false;
+}
+
+bool StackMonitor::allocate(const size_t size)
+{
+    release();
+#if UTEST_ALTERNATE_STACK_AVAILABLE
+    const size_t page = sysconf(_SC_PAGESIZE);
+    const size_t length = ((size + page - 1) / page + 1) * page;
+    void *memory = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_STACK, -1, 0);
+    if (memory == MAP_FAILED)
+        return false;
+    // the guard page below the stack
+    if (mprotect(memory, page, PROT_NONE) != 0) {
+        munmap(memory, length);
+        return false;
+    }
+    if (contexts == NULL) contexts = new contexts_t();
+    mapping = memory;
+    mapping_size = length;
+    attach(static_cast<uint8_t*>(memory) + page, length - page);
+    return true;
+#else
+    (void) size;
+    return false;
+#endif
+}
+
+void StackMonitor::release()
+{
+#if UTEST_ALTERNATE_STACK_AVAILABLE
+    if (mapping) munmap(mapping, mapping_size);
+#endif
+    mapping = NULL;
+    mapping_size = 0;
+    bottom = top = NULL;
+    is_painted = false;
+}
+
+void StackMonitor::execute(const uint32_t high, const uint32_t low)
+{
+    StackMonitor *self = reinterpret_cast<StackMonitor*>((uintptr_t(high) << 16 << 16) | uintptr_t(low));
+    self->function(self->context);
+}
+
+void StackMonitor::run(void (*function)(void*), void *context)
+{
+#if UTEST_ALTERNATE_STACK_AVAILABLE
+    if (mapping && !is_executing()) {
+        this->function = function;
+        this->context = context;
+        getcontext(&contexts->stack);
+        contexts->stack.uc_stack.ss_sp = bottom;
+        contexts->stack.uc_stack.ss_size = (top - bottom) * sizeof(uintptr_t);
+        contexts->stack.uc_link = &contexts->caller;
+        // `makecontext()` only passes `int` arguments, so the pointer is split into two halves
+        const uintptr_t self = uintptr_t(this);
+        makecontext(&contexts->stack, reinterpret_cast<void (*)()>(execute), 2, uint32_t(self >> 16 >> 16), uint32_t(self));
+        swapcontext(&contexts->caller, &contexts->stack);
+        return;
+    }
+#endif
+    function(context);
+}
+
+bool StackMonitor::is_executing() const
+{
+    volatile uintptr_t marker = 0;
+    const uintptr_t *const address = const_cast<const uintptr_t*>(&marker);
+    return (address >= bottom && address < top);
+}
+
+uintptr_t *StackMonitor::find_used() const
+{
+    uintptr_t *word = bottom;
+    while (word < top && *word == stack_pattern) word++;
+    return word;
+}
+
+void StackMonitor::paint()
+{
+    if (bottom == NULL)
+        return;
+
+    uintptr_t *end = top;
+    volatile uintptr_t marker = 0;
+    const uintptr_t frame = uintptr_t(&marker);
+    if (frame >= uintptr_t(bottom) && frame < uintptr_t(top)) {
+        // the frames of the caller and of this function are in use
+        if (frame - uintptr_t(bottom) < UTEST_STACK_PAINT_MARGIN)
+            return;
+        end = reinterpret_cast<uintptr_t*>((frame - UTEST_STACK_PAINT_MARGIN) & ~uintptr_t(sizeof(uintptr_t) - 1));
+    }
+    // only the words used since the stack was last painted need to be painted again
+    for (uintptr_t *word = is_painted ? find_used() : bottom; word < end; word++)
+        *word = stack_pattern;
+    is_painted = true;
+}
+
+size_t StackMonitor::get_peak() const
+{
+    if (!is_painted)
+        return 0;
+    return (top - find_used()) * sizeof(uintptr_t);
+}
@@ -0,0 +1,178 @@
+/****************************************************************************
+ * Copyright (c) 2016, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ****************************************************************************
+ */
+
+#include "utest/timer_queue.h"
+
+using namespace utest::v1;
+
+// the handle stores the slot index in the lower 16 bits and the slot generation above.
+static const uint16_t NO_SLOT = 0xffff;
+static const uintptr_t GENERATION_MASK = uintptr_t(-1) >> 16;
+
+TimerQueue::TimerQueue()
+{
+    for (uint16_t ii = 0; ii < UTEST_TIMER_QUEUE_SIZE; ii++) {
+        slots[ii].generation = 1;
+    }
+    clear();
+}
+
+void TimerQueue::clear()
+{
+    for (uint16_t ii = 0; ii < UTEST_TIMER_QUEUE_SIZE; ii++) {
+        slots[ii].heap_index = NO_SLOT;
+        slots[ii].generation = (slots[ii].generation + 1) & GENERATION_MASK;
+        slots[ii].next_free = (ii + 1 < UTEST_TIMER_QUEUE_SIZE) ? (ii + 1) : NO_SLOT;
+    }
+    length = 0;
+    free_slot = 0;
+    sequence = 0;
+}
+
+void *TimerQueue::insert(const utest_v1_harness_callback_t callback, const uint32_t timestamp)
+{
+    if (callback == NULL) return NULL;
+    callback_t entry = {callback, NULL, NULL};
+    return insert_callback(entry, timestamp);
+}
+
+void *TimerQueue::insert(const utest_v1_harness_callback_v2_t callback, void *context, const uint32_t timestamp)
+{
+    if (callback == NULL) return NULL;
+    callback_t entry = {NULL, callback, context};
+    return insert_callback(entry, timestamp);
+}
+
+void *TimerQueue::insert_callback(const callback_t &callback, const uint32_t timestamp)
+{
+    if (free_slot == NO_SLOT) return NULL;
+
+    const uint16_t index = free_slot;
+    slot_t &slot = slots[index];
+    free_slot = slot.next_free;
+
+    slot.callback = callback;
+    slot.timestamp = timestamp;
+    slot.sequence = sequence++;
+    slot.heap_index = length;
+    heap[length++] = index;
+    sift_up(slot.heap_index);
+
+    return (void*)((uintptr_t(slot.generation) << 16) | (index + 1));
+}
+
+bool TimerQueue::cancel(void *handle)
+{
+    const uintptr_t value = uintptr_t(handle);
+    const uintptr_t index = (value & 0xffff) - 1;
+
+    if (index >= UTEST_TIMER_QUEUE_SIZE) return false;
+    if (slots[index].heap_index == NO_SLOT) return false;
+    if (slots[index].generation != (value >> 16)) return false;
+
+    remove(uint16_t(index));
+    return true;
+}
+
+bool TimerQueue::is_empty() const
+{
+    return (length == 0);
+}
+
+uint32_t TimerQueue::get_next_timestamp() const
+{
+    return slots[heap[0]].timestamp;
+}
+
+bool TimerQueue::pop_expired(const uint32_t now, callback_t &callback)
+{
+    if (length == 0) return false;
+
+    const uint16_t index = heap[0];
+    if (int32_t(slots[index].timestamp - now) > 0) return false;
+
+    callback = slots[index].callback;
+    remove(index);
+    return true;
+}
+
+bool TimerQueue::is_before(const uint16_t lhs, const uint16_t rhs) const
+{
+    const slot_t &left = slots[heap[lhs]];
+    const slot_t &right = slots[heap[rhs]];
+    const int32_t difference = int32_t(left.timestamp - right.timestamp);
+    if (difference != 0) return (difference < 0);
+    // keep callbacks with equal timestamps in FIFO order
+    return (int32_t(left.sequence - right.sequence) < 0);
+}
+
+void TimerQueue::swap(const uint16_t lhs, const uint16_t rhs)
+{
+    const uint16_t index = heap[lhs];
+    heap[lhs] = heap[rhs];
+    heap[rhs] = index;
+    slots[heap[lhs]].heap_index = lhs;
+    slots[heap[rhs]].heap_index = rhs;
+}
+
+void TimerQueue::sift_up(uint16_t index)
+{
+    while (index > 0)
+    {
+        const uint16_t parent = (index - 1) / 2;
+        if (!is_before(index, parent)) break;
+        swap(index, parent);
+        index = parent;
+    }
+}
+
+void TimerQueue::sift_down(uint16_t index)
+{
+    while (1)
+    {
+        const uint16_t left = 2 * index + 1;
+        const uint16_t right = left + 1;
+        uint16_t smallest = index;
+
+        if (left < length && is_before(left, smallest)) smallest = left;
+        if (right < length && is_before(right, smallest)) smallest = right;
+        if (smallest == index) break;
+
+        swap(index, smallest);
+        index = smallest;
+    }
+}
+
+void TimerQueue::remove(const uint16_t index)
+{
+    slot_t &slot = slots[index];
+    const uint16_t position = slot.heap_index;
+
+    // move the last element into the hole and restore the heap property
+    length--;
+    if (position != length) {
+        swap(position, length);
+        if (position > 0 && is_before(position, (position - 1) / 2)) sift_up(position);
+        else sift_down(position);
+    }
+
+    slot.heap_index = NO_SLOT;
+    slot.generation = (slot.generation + 1) & GENERATION_MASK;
+    slot.next_free = free_slot;
+    free_slot = index;
+}
@@ -59,6 +59,24 @@ const char* utest::v1::stringify(utest::v1::failure_reason_t reason)
         case REASON_SCHEDULER:
             string = "Ignored: Scheduling Asynchronous Callback Failed";
             break;
+        case REASON_PERF_REGRESSION:
+            string = "Ignored: Performance Regression";
+            break;
+        case REASON_TIMEOUT_HEADROOM:
+            string = "Ignored: Validated Close to Timeout";
+            break;
+        case REASON_ALLOCATION:
+            string = "Ignored: Heap Allocation in Case Handler";
+            break;
+        case REASON_STACK_BUDGET:
+            string = "Ignored: Stack Budget Exceeded";
+            break;
+        case REASON_CRASH:
+            string = "Ignored: Case Handler Crashed";
+            break;
+        case REASON_NO_CLOCK:
+            string = "Ignored: No Clock for Benchmark";
+            break;
         default:
         case REASON_UNKNOWN:
             string = "Ignored: Unknown Failure";
@@ -0,0 +1,240 @@
+/****************************************************************************
+ * Copyright (c) 2016, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ****************************************************************************
+ */
+
+#include "utest/virtual_scheduler.h"
+#include "utest/timer_queue.h"
+#include "utest/default_handlers.h"
+#include "utest/case.h"
+#include "utest/harness.h"
+#include "utest/shim.h"
+
+using namespace utest::v1;
+
+namespace
+{
+    // the callbacks are dispatched by either version of the base scheduler
+    utest_v1_scheduler_t base_scheduler = {NULL, NULL, NULL, NULL};
+    utest_v1_scheduler_v2_t base_scheduler_v2 = {0, NULL, NULL, NULL, NULL, NULL};
+    TimerQueue virtual_queue;
+
+    // all delays are in milliseconds, so the deadlines are kept in milliseconds as well.
+    // the queue compares them modulo overflow, so they must lie within 2^31 milliseconds of each other.
+    const uint32_t max_delay_ms = 0x7fffffff;
+    uint32_t virtual_now = 0;
+    uint64_t virtual_elapsed = 0;   ///< in microseconds
+    // only one dispatch callback is posted to the base scheduler at any given time
+    bool dispatch_pending = false;
+
+    uint64_t case_virtual_start = 0;
+    uint64_t case_real_start = 0;
+}
+
+static void virtual_dispatch();
+static void virtual_dispatch_v2(void *);
+
+// delays of more than 24 days are clamped, which makes no difference to a test
+static uint32_t virtual_deadline(const uint32_t delay_ms)
+{
+    return virtual_now + ((delay_ms < max_delay_ms) ? delay_ms : max_delay_ms);
+}
+
+// @note must be called inside a critical section.
+static bool virtual_post_dispatch()
+{
+    if (dispatch_pending || virtual_queue.is_empty()) return true;
+    if (base_scheduler_v2.post) {
+        dispatch_pending = (base_scheduler_v2.post(virtual_dispatch_v2, NULL, 0) != NULL);
+    } else {
+        dispatch_pending = (base_scheduler.post(virtual_dispatch, 0) != NULL);
+    }
+    return dispatch_pending;
+}
+
+static void virtual_dispatch()
+{
+    TimerQueue::callback_t callback;
+    bool expired;
+    bool is_stalled;
+    {
+        UTEST_ENTER_CRITICAL_SECTION;
+        dispatch_pending = false;
+        expired = virtual_queue.pop_expired(virtual_now, callback);
+        if (!expired && !virtual_queue.is_empty())
+        {
+            // nothing is runnable, so fast-forward to the next deadline
+            const uint32_t deadline = virtual_queue.get_next_timestamp();
+            virtual_elapsed += uint64_t(deadline - virtual_now) * 1000;
+            virtual_now = deadline;
+            expired = virtual_queue.pop_expired(virtual_now, callback);
+        }
+        is_stalled = !virtual_post_dispatch();
+        UTEST_LEAVE_CRITICAL_SECTION;
+    }
+    if (expired) callback();
+
+    if (is_stalled) {
+        // the callback may have posted, which already retried the dispatch
+        UTEST_ENTER_CRITICAL_SECTION;
+        is_stalled = !virtual_post_dispatch();
+        UTEST_LEAVE_CRITICAL_SECTION;
+    }
+    // otherwise the pending callbacks only execute once another callback is posted
+    if (is_stalled) Harness::raise_failure(REASON_SCHEDULER);
+}
+
+static void virtual_dispatch_v2(void *)
+{
+    virtual_dispatch();
+}
+
+static int32_t utest_virtual_init()
+{
+    int32_t ret = base_scheduler_v2.init ? base_scheduler_v2.init() : base_scheduler.init();
+    {
+        UTEST_ENTER_CRITICAL_SECTION;
+        virtual_queue.clear();
+        virtual_now = 0;
+        virtual_elapsed = 0;
+        dispatch_pending = false;
+        UTEST_LEAVE_CRITICAL_SECTION;
+    }
+    return ret;
+}
+static void *utest_virtual_post(const utest_v1_harness_callback_t callback, const uint32_t delay_ms)
+{
+    void *handle;
+    {
+        UTEST_ENTER_CRITICAL_SECTION;
+        handle = virtual_queue.insert(callback, virtual_deadline(delay_ms));
+        if (handle && !virtual_post_dispatch()) {
+            virtual_queue.cancel(handle);
+            handle = NULL;
+        }
+        UTEST_LEAVE_CRITICAL_SECTION;
+    }
+    return handle;
+}
+static int32_t utest_virtual_cancel(void *handle)
+{
+    int32_t ret;
+    {
+        UTEST_ENTER_CRITICAL_SECTION;
+        ret = virtual_queue.cancel(handle) ? 0 : -1;
+        UTEST_LEAVE_CRITICAL_SECTION;
+    }
+    return ret;
+}
+static utest_v1_scheduler_handle_t utest_virtual_post_v2(const utest_v1_harness_callback_v2_t callback, void *context, const uint32_t delay_ms)
+{
+    void *handle;
+    {
+        UTEST_ENTER_CRITICAL_SECTION;
+        handle = virtual_queue.insert(callback, context, virtual_deadline(delay_ms));
+        if (handle && !virtual_post_dispatch()) {
+            virtual_queue.cancel(handle);
+            handle = NULL;
+        }
+        UTEST_LEAVE_CRITICAL_SECTION;
+    }
+    return (utest_v1_scheduler_handle_t) handle;
+}
+static int32_t utest_virtual_cancel_v2(utest_v1_scheduler_handle_t handle)
+{
+    return utest_virtual_cancel(handle);
+}
+static size_t utest_virtual_post_batch(utest_v1_scheduler_post_t *const posts, const size_t count)
+{
+    size_t ii;
+    {
+        UTEST_ENTER_CRITICAL_SECTION;
+        for (ii = 0; ii < count; ii++) {
+            posts[ii].handle = (utest_v1_scheduler_handle_t) virtual_queue.insert(posts[ii].callback, posts[ii].context, virtual_deadline(posts[ii].delay_ms));
+            if (posts[ii].handle == NULL) break;
+        }
+        if (ii && !virtual_post_dispatch()) {
+            while (ii) virtual_queue.cancel(posts[--ii].handle);
+        }
+        UTEST_LEAVE_CRITICAL_SECTION;
+    }
+    return ii;
+}
+static int32_t utest_virtual_run()
+{
+    return base_scheduler_v2.run ? base_scheduler_v2.run() : base_scheduler.run();
+}
+
+extern "C" {
+static const utest_v1_scheduler_t utest_v1_virtual_scheduler =
+{
+    utest_virtual_init,
+    utest_virtual_post,
+    utest_virtual_cancel,
+    utest_virtual_run
+};
+static const utest_v1_scheduler_v2_t utest_v1_virtual_scheduler_v2 =
+{
+    UTEST_V1_SCHEDULER_VERSION_2,
+    utest_virtual_init,
+    utest_virtual_post_v2,
+    utest_virtual_cancel_v2,
+    utest_virtual_post_batch,
+    utest_virtual_run
+};
+utest_v1_scheduler_t utest_v1_get_virtual_scheduler(const utest_v1_scheduler_t base)
+{
+    const utest_v1_scheduler_v2_t invalid = {0, NULL, NULL, NULL, NULL, NULL};
+    base_scheduler = base;
+    base_scheduler_v2 = invalid;
+    return utest_v1_virtual_scheduler;
+}
+utest_v1_scheduler_v2_t utest_v1_get_virtual_scheduler_v2(const utest_v1_scheduler_v2_t base)
+{
+    const utest_v1_scheduler_t invalid = {NULL, NULL, NULL, NULL};
+    base_scheduler = invalid;
+    base_scheduler_v2 = base;
+    return utest_v1_virtual_scheduler_v2;
+}
+uint64_t utest_v1_get_virtual_time_us(void)
+{
+    uint64_t elapsed;
+    {
+        UTEST_ENTER_CRITICAL_SECTION;
+        elapsed = virtual_elapsed;
+        UTEST_LEAVE_CRITICAL_SECTION;
+    }
+    return elapsed;
+}
+}
+
+status_t utest::v1::virtual_time_case_setup_handler(const Case *const source, const size_t index_of_case)
+{
+    status_t status = greentea_case_setup_handler(source, index_of_case);
+    case_virtual_start = utest_v1_get_virtual_time_us();
+    case_real_start = utest_v1_get_time_ns();
+    return status;
+}
+
+status_t utest::v1::virtual_time_case_teardown_handler(const Case *const source, const size_t passed, const size_t failed, const failure_t failure)
+{
+    const uint64_t real_us = (utest_v1_get_time_ns() - case_real_start) / 1000;
+    const uint64_t virtual_us = utest_v1_get_virtual_time_us() - case_virtual_start;
+    printf(">>> '%s': %lu.%03lums virtual time, %lu.%03lums real time\n", source->get_description(),
+           (unsigned long)(virtual_us / 1000), (unsigned long)(virtual_us % 1000),
+           (unsigned long)(real_us / 1000), (unsigned long)(real_us % 1000));
+    return greentea_case_teardown_handler(source, passed, failed, failure);
+}
@@ -0,0 +1,202 @@
+/****************************************************************************
+ * Copyright (c) 2016, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ****************************************************************************
+ */
+
+#include "utest/worker_pool.h"
+
+using namespace utest::v1;
+
+#if UTEST_WORKER_POOL_AVAILABLE
+
+#include <pthread.h>
+
+struct WorkerPool::state_t
+{
+    pthread_mutex_t lock;
+    pthread_cond_t work;    ///< signaled when a batch is dispatched or the workers are stopped
+    pthread_cond_t done;    ///< signaled when a job finished
+
+    pthread_t *threads;
+    size_t workers;
+    bool stopping;
+
+    // the current batch, `count` is zero if there is none
+    job_t job;
+    void *context;
+    size_t count;
+    size_t next;
+    size_t finished;
+    bool *is_finished;
+};
+
+void *WorkerPool::worker_main(void *argument)
+{
+    state_t *const state = static_cast<state_t*>(argument);
+
+    pthread_mutex_lock(&state->lock);
+    while(1)
+    {
+        if (state->next < state->count) {
+            // claim the next job in index order
+            const size_t index = state->next++;
+            const job_t job = state->job;
+            void *const context = state->context;
+            pthread_mutex_unlock(&state->lock);
+
+            job(context, index);
+
+            pthread_mutex_lock(&state->lock);
+            state->is_finished[index] = true;
+            state->finished++;
+            pthread_cond_broadcast(&state->done);
+        }
+        else if (state->stopping) {
+            break;
+        }
+        else {
+            pthread_cond_wait(&state->work, &state->lock);
+        }
+    }
+    pthread_mutex_unlock(&state->lock);
+    return NULL;
+}
+
+WorkerPool::WorkerPool() :
+    state(new state_t)
+{
+    pthread_mutex_init(&state->lock, NULL);
+    pthread_cond_init(&state->work, NULL);
+    pthread_cond_init(&state->done, NULL);
+    state->threads = NULL;
+    state->workers = 0;
+    state->stopping = false;
+    state->job = NULL;
+    state->context = NULL;
+    state->count = 0;
+    state->next = 0;
+    state->finished = 0;
+    state->is_finished = NULL;
+}
+
+WorkerPool::~WorkerPool()
+{
+    stop();
+    pthread_cond_destroy(&state->done);
+    pthread_cond_destroy(&state->work);
+    pthread_mutex_destroy(&state->lock);
+    delete state;
+}
+
+bool WorkerPool::start(const size_t count)
+{
+    stop();
+    if (count == 0) return true;
+
+    state->threads = new pthread_t[count];
+    for (size_t ii = 0; ii < count; ii++)
+    {
+        if (pthread_create(&state->threads[ii], NULL, worker_main, state) != 0) {
+            state->workers = ii;
+            stop();
+            return false;
+        }
+    }
+    state->workers = count;
+    return true;
+}
+
+void WorkerPool::stop()
+{
+    wait_all();
+
+    pthread_mutex_lock(&state->lock);
+    state->stopping = true;
+    pthread_cond_broadcast(&state->work);
+    pthread_mutex_unlock(&state->lock);
+
+    for (size_t ii = 0; ii < state->workers; ii++) {
+        pthread_join(state->threads[ii], NULL);
+    }
+    delete[] state->threads;
+    state->threads = NULL;
+    state->workers = 0;
+    state->stopping = false;
+}
+
+size_t WorkerPool::get_workers() const
+{
+    return state->workers;
+}
+
+bool WorkerPool::dispatch(const job_t job, void *context, const size_t count)
+{
+    if (state->workers == 0 || job == NULL || count == 0) return false;
+
+    pthread_mutex_lock(&state->lock);
+    const bool is_idle = (state->count == 0);
+    if (is_idle) {
+        state->is_finished = new bool[count]();
+        state->job = job;
+        state->context = context;
+        state->next = 0;
+        state->finished = 0;
+        state->count = count;
+        pthread_cond_broadcast(&state->work);
+    }
+    pthread_mutex_unlock(&state->lock);
+    return is_idle;
+}
+
+void WorkerPool::wait(const size_t index)
+{
+    pthread_mutex_lock(&state->lock);
+    if (index < state->count) {
+        while (!state->is_finished[index]) {
+            pthread_cond_wait(&state->done, &state->lock);
+        }
+    }
+    pthread_mutex_unlock(&state->lock);
+}
+
+void WorkerPool::wait_all()
+{
+    pthread_mutex_lock(&state->lock);
+    while (state->finished < state->count) {
+        pthread_cond_wait(&state->done, &state->lock);
+    }
+    delete[] state->is_finished;
+    state->is_finished = NULL;
+    state->count = 0;
+    state->next = 0;
+    state->finished = 0;
+    pthread_mutex_unlock(&state->lock);
+}
+
+#else
+
+// without threads no worker can be started, so all jobs execute serially in the harness.
+WorkerPool::WorkerPool() : state(NULL) {}
+WorkerPool::~WorkerPool() {}
+bool WorkerPool::start(const size_t count) { return (count == 0); }
+void WorkerPool::stop() {}
+size_t WorkerPool::get_workers() const { return 0; }
+bool WorkerPool::dispatch(const job_t, void *, const size_t) { return false; }
+void WorkerPool::wait(const size_t) {}
+void WorkerPool::wait_all() {}
+void *WorkerPool::worker_main(void *) { return NULL; }
+
+#endif
@@ -0,0 +1,127 @@
+/****************************************************************************
+ * Copyright (c) 2016, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ****************************************************************************
+ */
+
+#include "greentea-client/test_env.h"
+#include "utest/utest.h"
+#include "unity/unity.h"
+#include "utest/benchmark.h"
+#include <stdio.h>
+#include <string.h>
+
+using namespace utest::v1;
+
+// without a file system the baseline cannot be loaded, in which case the baseline test cases are skipped
+static const char *const load_path = "/tmp/utest_benchmark_baseline.txt";
+static const char *const save_path = "/tmp/utest_benchmark_samples.txt";
+static bool has_baseline = false;
+static int regression_count = 0;
+static volatile uint32_t accumulator = 0;
+
+// --- STATISTICS ---
+void test_compare()
+{
+    const double baseline[] = {10, 11, 12, 13, 14, 15, 16, 17, 18, 19};
+    const double slower[] = {20, 21, 22, 23, 24, 25, 26, 27, 28, 29};
+    const double faster[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    const double equal[] = {10, 11, 12, 13, 14, 15, 16, 17, 18, 19};
+
+    TEST_ASSERT_TRUE(Benchmark::compare(slower, 10, baseline, 10) < 0.001);
+    TEST_ASSERT_TRUE(Benchmark::compare(faster, 10, baseline, 10) > 0.999);
+    TEST_ASSERT_TRUE(Benchmark::compare(equal, 10, baseline, 10) > 0.4);
+    // all samples tied
+    TEST_ASSERT_TRUE(Benchmark::compare(baseline, 1, baseline, 1) == 1);
+}
+
+void test_load()
+{
+    if (!has_baseline) return;
+
+    BenchmarkBaseline baseline;
+    TEST_ASSERT_TRUE(baseline.open(load_path, NULL));
+    double samples[4];
+    TEST_ASSERT_EQUAL(0, baseline.load("Unknown benchmark", samples, 4));
+    TEST_ASSERT_EQUAL(0, baseline.load("Regressing", samples, 4));
+    // more baseline samples than requested are chosen evenly
+    TEST_ASSERT_EQUAL(4, baseline.load("Subsampled baseline", samples, 4));
+    TEST_ASSERT_TRUE(samples[0] == 1 && samples[1] == 3 && samples[2] == 5 && samples[3] == 7);
+}
+
+// --- BENCHMARKS ---
+void benchmark_accumulate(const size_t iterations)
+{
+    for (size_t ii = 0; ii < iterations; ii++) {
+        accumulator += ii;
+    }
+}
+
+status_t expected_regression(const Case *const, const failure_t failure)
+{
+    TEST_ASSERT_EQUAL(REASON_PERF_REGRESSION, failure.reason);
+    TEST_ASSERT_EQUAL(LOCATION_CASE_HANDLER, failure.location);
+    regression_count++;
+    return STATUS_IGNORE;
+}
+
+void test_results()
+{
+    if (!has_baseline) return;
+
+    TEST_ASSERT_EQUAL(1, regression_count);
+    // the samples of all benchmarks have been recorded
+    BenchmarkBaseline samples;
+    TEST_ASSERT_TRUE(samples.open(save_path, NULL));
+    double sample_ns[UTEST_BENCHMARK_SAMPLES];
+    TEST_ASSERT_EQUAL(UTEST_BENCHMARK_SAMPLES, samples.load("Regressing benchmark", sample_ns, UTEST_BENCHMARK_SAMPLES));
+    TEST_ASSERT_EQUAL(UTEST_BENCHMARK_SAMPLES, samples.load("Improving benchmark", sample_ns, UTEST_BENCHMARK_SAMPLES));
+    TEST_ASSERT_EQUAL(UTEST_BENCHMARK_SAMPLES, samples.load("Benchmark without baseline", sample_ns, UTEST_BENCHMARK_SAMPLES));
+    remove(load_path);
+    remove(save_path);
+}
+
+Case cases[] =
+{
+    Case("Comparing samples", test_compare),
+    Case("Loading a baseline", test_load),
+    Case("Regressing benchmark", benchmark_accumulate, expected_regression),
+    Case("Improving benchmark", benchmark_accumulate),
+    Case("Benchmark without baseline", benchmark_accumulate),
+    Case("Testing results", test_results)
+};
+
+status_t greentea_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(15, "default_auto");
+
+    return greentea_test_setup_handler(number_of_cases);
+};
+Specification specification(greentea_setup, cases, greentea_continue_handlers);
+
+void app_start(int, char*[])
+{
+    FILE *file = fopen(load_path, "w");
+    if (file) {
+        // no operation takes less than a picosecond or more than a second
+        fprintf(file, "# baseline\n");
+        fprintf(file, "Regressing benchmark\t0.001 0.001 0.001 0.001 0.001 0.001 0.001 0.001 0.001 0.001\n");
+        fprintf(file, "Improving benchmark\t1e9 1e9 1e9 1e9 1e9 1e9 1e9 1e9 1e9 1e9\n");
+        fprintf(file, "Subsampled baseline\t1 2 3 4 5 6 7 8\n");
+        fclose(file);
+        has_baseline = Harness::set_baseline(load_path, save_path);
+    }
+    Harness::run(specification);
+}
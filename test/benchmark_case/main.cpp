@@ -0,0 +1,132 @@
+/****************************************************************************
+ * Copyright (c) 2016, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ****************************************************************************
+ */
+
+#include "greentea-client/test_env.h"
+#include "utest/utest.h"
+#include "unity/unity.h"
+#include "utest/benchmark.h"
+
+using namespace utest::v1;
+
+static volatile uint32_t accumulator = 0;
+static size_t total_iterations = 0;
+static size_t report_count = 0;
+static benchmark_result_t report;
+static bool is_sorted = false;
+
+void record_benchmark(const Case *const source, const benchmark_result_t result)
+{
+    verbose_case_benchmark_handler(source, result);
+    report_count++;
+    report = result;
+    is_sorted = true;
+    for (size_t ii = 1; ii < result.samples; ii++) {
+        if (result.sample_ns[ii - 1] > result.sample_ns[ii]) is_sorted = false;
+    }
+}
+
+// --- STATISTICS ---
+void test_evaluate()
+{
+    double samples[] = {5, 1, 4, 2, 3};
+    const benchmark_result_t result = Benchmark::evaluate(samples, 5, 10);
+
+    TEST_ASSERT_EQUAL(10, result.iterations);
+    TEST_ASSERT_EQUAL(5, result.samples);
+    TEST_ASSERT_EQUAL_PTR(samples, result.sample_ns);
+    for (int ii = 0; ii < 5; ii++) {
+        TEST_ASSERT_TRUE(samples[ii] == ii + 1);
+    }
+    TEST_ASSERT_TRUE(result.min_ns == 1);
+    TEST_ASSERT_TRUE(result.median_ns == 3);
+    TEST_ASSERT_TRUE(result.p90_ns == 5);
+    TEST_ASSERT_TRUE(result.p99_ns == 5);
+    TEST_ASSERT_TRUE(result.mean_ns == 3);
+    // sample standard deviation of 1..5 is sqrt(2.5)
+    TEST_ASSERT_TRUE(result.stddev_ns > 1.581 && result.stddev_ns < 1.582);
+}
+
+void test_calibrate()
+{
+    // the target has been reached
+    TEST_ASSERT_EQUAL(0, Benchmark::calibrate(100, 1000, 1000));
+    // aim 20% above the target
+    TEST_ASSERT_EQUAL(120, Benchmark::calibrate(10, 100, 1000));
+    // the growth is limited
+    TEST_ASSERT_EQUAL(1000, Benchmark::calibrate(10, 0, 1000));
+    TEST_ASSERT_EQUAL(1000, Benchmark::calibrate(10, 1, 1000000));
+    // the iterations always grow
+    TEST_ASSERT_EQUAL(2, Benchmark::calibrate(1, 999, 1000));
+}
+
+// --- BENCHMARK ---
+void benchmark_accumulate(const size_t iterations)
+{
+    total_iterations += iterations;
+    for (size_t ii = 0; ii < iterations; ii++) {
+        accumulator += ii;
+    }
+}
+
+void test_results()
+{
+    TEST_ASSERT_EQUAL(1, report_count);
+    TEST_ASSERT_EQUAL(UTEST_BENCHMARK_SAMPLES, report.samples);
+    TEST_ASSERT_TRUE(report.iterations > 1);
+    // calibration, warmup and samples have been executed
+    TEST_ASSERT_TRUE(total_iterations >= report.iterations * (UTEST_BENCHMARK_SAMPLES + UTEST_BENCHMARK_WARMUP_SAMPLES));
+    TEST_ASSERT_TRUE(is_sorted);
+    TEST_ASSERT_TRUE(report.min_ns > 0);
+    TEST_ASSERT_TRUE(report.min_ns <= report.median_ns);
+    TEST_ASSERT_TRUE(report.median_ns <= report.p90_ns);
+    TEST_ASSERT_TRUE(report.p90_ns <= report.p99_ns);
+    TEST_ASSERT_TRUE(report.mean_ns >= report.min_ns);
+}
+
+Case cases[] =
+{
+    Case("Evaluating samples", test_evaluate),
+    Case("Calibrating iterations", test_calibrate),
+    Case("Benchmarking an operation", benchmark_accumulate),
+    Case("Testing results", test_results)
+};
+
+status_t greentea_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(15, "default_auto");
+
+    return greentea_test_setup_handler(number_of_cases);
+};
+
+const handlers_t benchmark_handlers = {
+    greentea_test_setup_handler,
+    greentea_test_teardown_handler,
+    greentea_test_failure_handler,
+    greentea_case_setup_handler,
+    greentea_case_teardown_handler,
+    greentea_case_failure_continue_handler,
+    record_benchmark,
+    verbose_case_comparison_handler,
+    ignore_handler
+};
+Specification specification(greentea_setup, cases, benchmark_handlers);
+
+void app_start(int, char*[])
+{
+    Harness::run(specification);
+}
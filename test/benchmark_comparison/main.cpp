@@ -0,0 +1,120 @@
+/****************************************************************************
+ * Copyright (c) 2016, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ****************************************************************************
+ */
+
+#include "greentea-client/test_env.h"
+#include "utest/utest.h"
+#include "unity/unity.h"
+#include "utest/benchmark.h"
+
+using namespace utest::v1;
+
+static volatile uint32_t accumulator = 0;
+static benchmark_comparison_t reports[2];
+static size_t report_count = 0;
+
+void record_comparison(const Case *const source, const benchmark_comparison_t comparison)
+{
+    verbose_case_comparison_handler(source, comparison);
+    if (report_count < 2) reports[report_count] = comparison;
+    report_count++;
+}
+
+// --- HANDLERS ---
+void accumulate_once(const size_t iterations)
+{
+    for (size_t ii = 0; ii < iterations; ii++) {
+        accumulator += ii;
+    }
+}
+
+void accumulate_twice(const size_t iterations)
+{
+    for (size_t ii = 0; ii < iterations; ii++) {
+        accumulator += ii;
+        accumulator += ii;
+    }
+}
+
+status_t comparison_teardown(const Case *const source, const size_t passed, const size_t failed, const failure_t failure)
+{
+    // the calibration and every block are repeats of the case handler
+    TEST_ASSERT_EQUAL(UTEST_BENCHMARK_SAMPLES + 1, passed);
+    TEST_ASSERT_EQUAL(0, failed);
+    return greentea_case_teardown_handler(source, passed, failed, failure);
+}
+
+// --- STATISTICS ---
+void test_evaluate()
+{
+    BenchmarkComparison comparison;
+    comparison.reset(1, 1, 0);
+    TEST_ASSERT_EQUAL(0, comparison.get_blocks());
+
+    const benchmark_comparison_t empty = comparison.evaluate();
+    TEST_ASSERT_EQUAL(0, empty.blocks);
+    TEST_ASSERT_TRUE(empty.ratio == 1);
+}
+
+void test_results()
+{
+    TEST_ASSERT_EQUAL(2, report_count);
+    for (size_t ii = 0; ii < 2; ii++) {
+        TEST_ASSERT_EQUAL(UTEST_BENCHMARK_SAMPLES, reports[ii].blocks);
+        TEST_ASSERT_TRUE(reports[ii].ratio_low <= reports[ii].ratio);
+        TEST_ASSERT_TRUE(reports[ii].ratio <= reports[ii].ratio_high);
+        TEST_ASSERT_TRUE(reports[ii].baseline_ns > 0);
+        TEST_ASSERT_TRUE(reports[ii].candidate_ns > 0);
+    }
+    // identical handlers
+    TEST_ASSERT_TRUE(reports[0].ratio > 0.8 && reports[0].ratio < 1.25);
+    // the candidate does twice the work
+    TEST_ASSERT_TRUE(reports[1].ratio > 1.3);
+}
+
+Case cases[] =
+{
+    Case("Evaluating without blocks", test_evaluate),
+    Case("Comparing identical handlers", accumulate_once, accumulate_once, comparison_teardown),
+    Case("Comparing a slower candidate", accumulate_once, accumulate_twice, comparison_teardown),
+    Case("Testing results", test_results)
+};
+
+status_t greentea_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(15, "default_auto");
+
+    return greentea_test_setup_handler(number_of_cases);
+};
+
+const handlers_t comparison_handlers = {
+    greentea_test_setup_handler,
+    greentea_test_teardown_handler,
+    greentea_test_failure_handler,
+    greentea_case_setup_handler,
+    greentea_case_teardown_handler,
+    greentea_case_failure_continue_handler,
+    verbose_case_benchmark_handler,
+    record_comparison,
+    ignore_handler
+};
+Specification specification(greentea_setup, cases, comparison_handlers);
+
+void app_start(int, char*[])
+{
+    Harness::run(specification);
+}
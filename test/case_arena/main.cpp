@@ -0,0 +1,141 @@
+/****************************************************************************
+ * Copyright (c) 2016, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ****************************************************************************
+ */
+
+#include "greentea-client/test_env.h"
+#include "utest/utest.h"
+#include "unity/unity.h"
+#include "utest/arena.h"
+#include <string.h>
+
+using namespace utest::v1;
+
+static const size_t arena_size = 64 * 1024;
+static void *first_allocation = NULL;
+static case_metrics_t reports[4];
+static size_t report_count = 0;
+
+void record_metrics(const Case *const source, const case_metrics_t &metrics)
+{
+    verbose_case_metrics_handler(source, metrics);
+    if (report_count < 4) reports[report_count] = metrics;
+    report_count++;
+}
+
+// --- ARENA ---
+void test_arena()
+{
+    Arena arena;
+    TEST_ASSERT_NULL(arena.allocate(1));
+    TEST_ASSERT_TRUE(arena.reserve(256));
+    TEST_ASSERT_EQUAL(256, arena.get_size());
+
+    uint8_t *first = static_cast<uint8_t*>(arena.allocate(10));
+    TEST_ASSERT_NOT_NULL(first);
+    TEST_ASSERT_EQUAL(0, uintptr_t(first) % 16);
+    // the next allocation is aligned again
+    uint8_t *second = static_cast<uint8_t*>(arena.allocate(10));
+    TEST_ASSERT_TRUE(second == first + 16);
+    TEST_ASSERT_EQUAL(26, arena.get_used());
+    TEST_ASSERT_EQUAL(0, uintptr_t(arena.allocate(1, 64)) % 64);
+    TEST_ASSERT_NULL(arena.allocate(256));
+
+    arena.reset();
+    TEST_ASSERT_EQUAL(0, arena.get_used());
+    TEST_ASSERT_TRUE(arena.allocate(256) == first);
+
+    // the arena also works, if neither reserved nor transparent huge pages are available
+    TEST_ASSERT_TRUE(arena.reserve(1024 * 1024, true));
+    TEST_ASSERT_TRUE(arena.get_size() >= 1024 * 1024);
+    uint8_t *block = static_cast<uint8_t*>(arena.allocate(1024 * 1024));
+    TEST_ASSERT_NOT_NULL(block);
+    memset(block, 0xA5, 1024 * 1024);
+}
+
+// --- CASES ---
+void allocating_case()
+{
+    first_allocation = Harness::allocate(100);
+    TEST_ASSERT_NOT_NULL(first_allocation);
+    TEST_ASSERT_EQUAL(0, uintptr_t(first_allocation) % 16);
+    memset(first_allocation, 0, 100);
+
+    void *second = Harness::allocate(100);
+    TEST_ASSERT_NOT_NULL(second);
+    TEST_ASSERT_TRUE(second != first_allocation);
+}
+
+void reset_case()
+{
+    // the allocations of the previous test case have been released
+    TEST_ASSERT_TRUE(Harness::allocate(100) == first_allocation);
+    // huge pages round the arena up to whole huge pages
+    TEST_ASSERT_NULL(Harness::allocate(4 * 1024 * 1024));
+}
+
+// the arena is released after the first of them, while the others are still running
+template< int N >
+control_t overlapped_case()
+{
+    TEST_ASSERT_NULL(Harness::allocate(100));
+    return CaseNext;
+}
+
+void test_results()
+{
+    TEST_ASSERT_EQUAL(5, report_count);
+    TEST_ASSERT_EQUAL(0, reports[0].arena_bytes);
+    TEST_ASSERT_TRUE(reports[1].arena_bytes >= 200);
+    TEST_ASSERT_TRUE(reports[2].arena_bytes >= 100 && reports[2].arena_bytes < 200);
+}
+
+Case cases[] =
+{
+    Case("Allocating from an arena", test_arena),
+    Case("Allocating in a test case", allocating_case),
+    Case("Releasing the allocations of the previous test case", reset_case),
+    Case("Allocating in an overlapped test case", overlapped_case<0>).with_attributes(CASE_ATTRIBUTE_OVERLAPPABLE),
+    Case("Allocating in another overlapped test case", overlapped_case<1>).with_attributes(CASE_ATTRIBUTE_OVERLAPPABLE),
+    Case("Testing results", test_results)
+};
+
+status_t greentea_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(15, "default_auto");
+
+    return greentea_test_setup_handler(number_of_cases);
+};
+
+const handlers_t arena_handlers = {
+    greentea_test_setup_handler,
+    greentea_test_teardown_handler,
+    greentea_test_failure_handler,
+    greentea_case_setup_handler,
+    greentea_case_teardown_handler,
+    greentea_case_failure_continue_handler,
+    verbose_case_benchmark_handler,
+    verbose_case_comparison_handler,
+    record_metrics
+};
+Specification specification(greentea_setup, cases, arena_handlers);
+
+void app_start(int, char*[])
+{
+    Harness::set_arena(arena_size, true);
+    Harness::set_pipelining(2);
+    Harness::run(specification);
+}
@@ -0,0 +1,145 @@
+/****************************************************************************
+ * Copyright (c) 2016, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ****************************************************************************
+ */
+
+#include "mbed-drivers/mbed.h"
+#include "greentea-client/test_env.h"
+#include "utest/utest.h"
+#include "unity/unity.h"
+#include "utest/worker_pool.h"
+
+using namespace utest::v1;
+
+static const uint64_t ms = 1000000ull;
+static const size_t fan_out = 1000;
+static WorkerPool workers;
+static bool has_workers = false;
+static int timeout_count = 0;
+
+void validate()
+{
+    Harness::validate_callback();
+}
+
+// --- SEVERAL CALLBACKS ---
+void validate_twice()
+{
+    Harness::validate_callback();
+    // the test case has been validated already, so this is ignored
+    Harness::validate_callback();
+}
+
+control_t several_callbacks_case()
+{
+    minar::Scheduler::postCallback(validate).delay(minar::milliseconds(10));
+    minar::Scheduler::postCallback(validate).delay(minar::milliseconds(20));
+    minar::Scheduler::postCallback(validate_twice).delay(minar::milliseconds(30));
+    return CaseAwaitCount(3, 1000);
+}
+
+status_t several_callbacks_teardown(const Case *const source, const size_t passed, const size_t failed, const failure_t failure)
+{
+    const case_metrics_t metrics = Harness::get_case_metrics();
+    TEST_ASSERT_EQUAL(1, passed);
+    TEST_ASSERT_EQUAL(0, failed);
+    // every validation records its latency, the wait ends with the last one
+    TEST_ASSERT_EQUAL(3, metrics.callbacks);
+    TEST_ASSERT_EQUAL(3, metrics.timeout_usage[0]);
+    TEST_ASSERT_TRUE(metrics.latency_max_ns >= 30 * ms);
+    TEST_ASSERT_TRUE(metrics.wait_ns >= metrics.latency_max_ns);
+    TEST_ASSERT_TRUE(metrics.wait_ns < 40 * ms);
+    return greentea_case_teardown_handler(source, passed, failed, failure);
+}
+
+// --- MISSING CALLBACKS ---
+control_t missing_callbacks_case()
+{
+    minar::Scheduler::postCallback(validate).delay(minar::milliseconds(10));
+    minar::Scheduler::postCallback(validate).delay(minar::milliseconds(20));
+    return CaseAwaitCount(3, 100);
+}
+
+status_t missing_callbacks_failure(const Case *const source, const failure_t failure)
+{
+    if (failure.reason != REASON_TIMEOUT) return greentea_case_failure_continue_handler(source, failure);
+    timeout_count++;
+    greentea_case_failure_continue_handler(source, failure);
+    return STATUS_IGNORE;
+}
+
+status_t missing_callbacks_teardown(const Case *const source, const size_t passed, const size_t failed, const failure_t failure)
+{
+    const case_metrics_t metrics = Harness::get_case_metrics();
+    TEST_ASSERT_EQUAL(1, timeout_count);
+    TEST_ASSERT_EQUAL(0, passed);
+    TEST_ASSERT_EQUAL(2, metrics.callbacks);
+    TEST_ASSERT_TRUE(metrics.wait_ns >= 100 * ms);
+    return greentea_case_teardown_handler(source, passed, failed, failure);
+}
+
+// --- CONCURRENT CALLBACKS ---
+void validate_concurrently(void *, const size_t)
+{
+    Harness::validate_callback();
+}
+
+void start_requests()
+{
+    TEST_ASSERT_TRUE(workers.dispatch(validate_concurrently, NULL, fan_out));
+}
+
+control_t concurrent_callbacks_case()
+{
+    // without workers the callbacks are validated one after the other on the scheduler
+    if (has_workers) minar::Scheduler::postCallback(start_requests).delay(minar::milliseconds(10));
+    else for (size_t ii = 0; ii < fan_out; ii++) minar::Scheduler::postCallback(validate).delay(minar::milliseconds(10));
+    return CaseAwaitCount(fan_out, 5000);
+}
+
+status_t concurrent_callbacks_teardown(const Case *const source, const size_t passed, const size_t failed, const failure_t failure)
+{
+    if (has_workers) workers.wait_all();
+    const case_metrics_t metrics = Harness::get_case_metrics();
+    TEST_ASSERT_EQUAL(1, passed);
+    TEST_ASSERT_EQUAL(0, failed);
+    TEST_ASSERT_EQUAL(fan_out, metrics.callbacks);
+    TEST_ASSERT_TRUE(metrics.latency_max_ns >= 10 * ms);
+    return greentea_case_teardown_handler(source, passed, failed, failure);
+}
+
+Case cases[] =
+{
+    Case("Awaiting several callbacks", several_callbacks_case, several_callbacks_teardown),
+    Case("Missing some of the callbacks", missing_callbacks_case, missing_callbacks_teardown, missing_callbacks_failure),
+    Case("Awaiting concurrent callbacks", concurrent_callbacks_case, concurrent_callbacks_teardown)
+};
+
+status_t greentea_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(15, "default_auto");
+
+    return greentea_test_setup_handler(number_of_cases);
+};
+
+Specification specification(greentea_setup, cases, greentea_continue_handlers);
+
+void app_start(int, char*[])
+{
+    has_workers = workers.start(4);
+    TEST_ASSERT_EQUAL(UTEST_WORKER_POOL_AVAILABLE, has_workers);
+    Harness::run(specification);
+}
@@ -0,0 +1,178 @@
+/****************************************************************************
+ * Copyright (c) 2016, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ****************************************************************************
+ */
+
+#include "greentea-client/test_env.h"
+#include "utest/utest.h"
+#include "unity/unity.h"
+#include <stdlib.h>
+
+using namespace utest::v1;
+
+// process isolation is not available on targets, in which case the crashing test cases are skipped
+static bool isolated = false;
+static int parent_state = 0;
+static int crash_reason = REASON_NONE;
+static int hang_reason = REASON_NONE;
+static int teardown_count = 0;
+
+// --- STATE ISOLATION ---
+void test_modify_state()
+{
+    parent_state = 1;
+}
+
+void test_state_isolated()
+{
+    if (isolated) {
+        TEST_ASSERT_EQUAL(0, parent_state);
+    }
+}
+
+// --- CRASHES AND HANGS ---
+void test_crash()
+{
+    if (isolated) abort();
+}
+
+void test_hang()
+{
+    while (isolated) ;
+}
+
+status_t expected_crash(const Case *const, const failure_t failure)
+{
+    crash_reason = failure.reason;
+    return STATUS_IGNORE;
+}
+
+status_t expected_hang(const Case *const, const failure_t failure)
+{
+    hang_reason = failure.reason;
+    return STATUS_IGNORE;
+}
+
+status_t record_teardown(const Case *const source, const size_t passed, const size_t failed, const failure_t failure)
+{
+    teardown_count++;
+    return greentea_case_teardown_handler(source, passed, failed, failure);
+}
+
+// --- ASYNCHRONOUS TEST CASE ---
+void async_validate(void *)
+{
+    Harness::validate_callback();
+}
+
+control_t test_async()
+{
+    utest_v1_get_scheduler_v2().post(async_validate, NULL, 50);
+    return CaseTimeout(1000);
+}
+
+// --- ABORT ---
+template< int N >
+struct manual_scheduler
+{
+    static utest_v1_harness_callback_v2_t callback;
+    static void *context;
+
+    static int32_t init() { callback = NULL; return 0; }
+    static utest_v1_scheduler_handle_t post(const utest_v1_harness_callback_v2_t callback, void *context, const uint32_t) {
+        manual_scheduler::callback = callback;
+        manual_scheduler::context = context;
+        return (utest_v1_scheduler_handle_t) &manual_scheduler::callback;
+    }
+    static int32_t cancel(utest_v1_scheduler_handle_t) { callback = NULL; return 0; }
+    static int32_t run() { return 0; }
+    static bool step() {
+        const utest_v1_harness_callback_v2_t current = callback;
+        callback = NULL;
+        if (current) current(context);
+        return (current != NULL);
+    }
+};
+template< int N > utest_v1_harness_callback_v2_t manual_scheduler<N>::callback = NULL;
+template< int N > void *manual_scheduler<N>::context = NULL;
+
+status_t abort_on_failure(const Case *const, const failure_t) {
+    return STATUS_ABORT;
+}
+void inner_pass() {}
+void inner_fail() {
+    TEST_ASSERT_TRUE_MESSAGE(false, "expected failure");
+}
+Case inner_cases[] = {
+    Case("Inner passing", inner_pass),
+    Case("Inner aborting", inner_fail, abort_on_failure),
+    Case("Inner passing after abort", inner_pass)
+};
+Specification inner_specification(inner_cases, verbose_continue_handlers);
+
+void test_abort_contained()
+{
+    if (!isolated) return;
+
+    HarnessContext context;
+    const utest_v1_scheduler_v2_t scheduler = {UTEST_V1_SCHEDULER_VERSION_2,
+        manual_scheduler<0>::init, manual_scheduler<0>::post, manual_scheduler<0>::cancel, NULL, manual_scheduler<0>::run};
+    TEST_ASSERT_TRUE(context.set_scheduler(scheduler));
+    TEST_ASSERT_TRUE(context.set_isolation(1));
+    TEST_ASSERT_TRUE(context.start(inner_specification));
+    while (manual_scheduler<0>::step()) ;
+
+    TEST_ASSERT_FALSE(context.is_busy());
+    TEST_ASSERT_EQUAL(2, context.get_passed());
+    TEST_ASSERT_EQUAL(1, context.get_failed());
+}
+
+// --- RESULTS ---
+void test_results()
+{
+    if (!isolated) return;
+
+    TEST_ASSERT_EQUAL(0, parent_state);
+    TEST_ASSERT_EQUAL(REASON_CASE_HANDLER, crash_reason);
+    TEST_ASSERT_EQUAL(REASON_TIMEOUT, hang_reason);
+    // the teardown handlers of the crashed and hanging test cases are called by the parent
+    TEST_ASSERT_EQUAL(2, teardown_count);
+}
+
+Case cases[] =
+{
+    Case("Modifying state", test_modify_state),
+    Case("State is isolated", test_state_isolated),
+    Case("Crash is contained", test_crash, record_teardown, expected_crash),
+    Case("Hang is contained", test_hang, record_teardown, expected_hang),
+    Case("Asynchronous validation", test_async),
+    Case("Abort is contained", test_abort_contained),
+    Case("Testing results", test_results)
+};
+
+status_t greentea_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(15, "default_auto");
+
+    return greentea_test_setup_handler(number_of_cases);
+};
+Specification specification(greentea_setup, cases, greentea_continue_handlers);
+
+void app_start(int, char*[])
+{
+    isolated = Harness::set_isolation(2, 500);
+    Harness::run(specification);
+}
@@ -0,0 +1,143 @@
+/****************************************************************************
+ * Copyright (c) 2016, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ****************************************************************************
+ */
+
+#include "mbed-drivers/mbed.h"
+#include "greentea-client/test_env.h"
+#include "utest/utest.h"
+#include "unity/unity.h"
+
+using namespace utest::v1;
+
+static const uint64_t ms = 1000000ull;
+static case_metrics_t reports[3];
+static size_t report_count = 0;
+
+static void spin(const uint64_t duration_ns)
+{
+    const uint64_t start = utest_v1_get_time_ns();
+    while (utest_v1_get_time_ns() - start < duration_ns) ;
+}
+
+void record_metrics(const Case *const source, const case_metrics_t &metrics)
+{
+    verbose_case_metrics_handler(source, metrics);
+    if (report_count < 3) reports[report_count] = metrics;
+    report_count++;
+}
+
+// --- PHASES ---
+status_t phases_setup(const Case *const source, const size_t index_of_case)
+{
+    spin(2 * ms);
+    return greentea_case_setup_handler(source, index_of_case);
+}
+
+void phases_case()
+{
+    spin(5 * ms);
+}
+
+status_t phases_teardown(const Case *const source, const size_t passed, const size_t failed, const failure_t failure)
+{
+    const case_metrics_t metrics = Harness::get_case_metrics();
+    TEST_ASSERT_TRUE(metrics.setup_ns >= 2 * ms);
+    TEST_ASSERT_TRUE(metrics.handler_ns >= 5 * ms);
+    TEST_ASSERT_TRUE(metrics.wait_ns == 0);
+    // this teardown is still running
+    TEST_ASSERT_TRUE(metrics.teardown_ns == 0);
+    spin(3 * ms);
+    return greentea_case_teardown_handler(source, passed, failed, failure);
+}
+
+// --- ASYNC WAIT ---
+void validate()
+{
+    Harness::validate_callback();
+}
+
+control_t wait_case()
+{
+    minar::Scheduler::postCallback(validate).delay(minar::milliseconds(50));
+    return CaseTimeout(1000);
+}
+
+status_t wait_teardown(const Case *const source, const size_t passed, const size_t failed, const failure_t failure)
+{
+    const case_metrics_t metrics = Harness::get_case_metrics();
+    TEST_ASSERT_TRUE(metrics.wait_ns >= 40 * ms);
+    TEST_ASSERT_TRUE(metrics.wait_ns < 1000 * ms);
+    return greentea_case_teardown_handler(source, passed, failed, failure);
+}
+
+// --- REPEATS ---
+control_t repeat_case(const size_t call_count)
+{
+    spin(1 * ms);
+    return (call_count < 3) ? CaseRepeatHandler : CaseNext;
+}
+
+status_t repeat_teardown(const Case *const source, const size_t passed, const size_t failed, const failure_t failure)
+{
+    TEST_ASSERT_EQUAL(3, passed);
+    TEST_ASSERT_TRUE(Harness::get_case_metrics().handler_ns >= 3 * ms);
+    return greentea_case_teardown_handler(source, passed, failed, failure);
+}
+
+void test_reports()
+{
+    TEST_ASSERT_EQUAL(3, report_count);
+    TEST_ASSERT_TRUE(reports[0].teardown_ns >= 3 * ms);
+    TEST_ASSERT_TRUE(reports[1].wait_ns >= 40 * ms);
+    TEST_ASSERT_TRUE(reports[2].handler_ns >= 3 * ms);
+    // the metrics were reset for every test case
+    TEST_ASSERT_TRUE(reports[1].setup_ns < 2 * ms);
+    TEST_ASSERT_TRUE(reports[2].wait_ns == 0);
+}
+
+Case cases[] =
+{
+    Case("Timing setup, handler and teardown", phases_setup, phases_case, phases_teardown),
+    Case("Timing an asynchronous wait", wait_case, wait_teardown),
+    Case("Timing a repeated handler", repeat_case, repeat_teardown),
+    Case("Testing reports", test_reports)
+};
+
+status_t greentea_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(15, "default_auto");
+
+    return greentea_test_setup_handler(number_of_cases);
+};
+
+const handlers_t metrics_handlers = {
+    greentea_test_setup_handler,
+    greentea_test_teardown_handler,
+    greentea_test_failure_handler,
+    greentea_case_setup_handler,
+    greentea_case_teardown_handler,
+    greentea_case_failure_continue_handler,
+    verbose_case_benchmark_handler,
+    verbose_case_comparison_handler,
+    record_metrics
+};
+Specification specification(greentea_setup, cases, metrics_handlers);
+
+void app_start(int, char*[])
+{
+    Harness::run(specification);
+}
@@ -0,0 +1,142 @@
+/****************************************************************************
+ * Copyright (c) 2016, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ****************************************************************************
+ */
+
+#include "mbed-drivers/mbed.h"
+#include "greentea-client/test_env.h"
+#include "utest/utest.h"
+#include "unity/unity.h"
+
+using namespace utest::v1;
+
+static const uint64_t ms = 1000000ull;
+static const Case *sources[4];
+static int handler_count = 0;
+static int teardown_order[4];
+static int teardown_count = 0;
+static int timeout_count = 0;
+static int ignored_count = 0;
+static uint64_t start_ns = 0;
+static uint64_t finish_ns = 0;
+
+// --- OVERLAPPED CALLBACKS ---
+void validate_first()
+{
+    Harness::validate_callback(sources[0]);
+}
+
+void validate_second()
+{
+    Harness::validate_callback(sources[1]);
+}
+
+void fail_third()
+{
+    Harness::raise_failure(sources[2], failure_reason_t(REASON_ASSERTION | REASON_IGNORE));
+    Harness::validate_callback(sources[2]);
+}
+
+control_t first_case()
+{
+    start_ns = utest_v1_get_time_ns();
+    sources[0] = Harness::get_current_case();
+    handler_count++;
+    minar::Scheduler::postCallback(validate_first).delay(minar::milliseconds(300));
+    return CaseTimeout(1000);
+}
+
+control_t second_case()
+{
+    sources[1] = Harness::get_current_case();
+    handler_count++;
+    // the handlers of all overlappable test cases are called before the first one is validated
+    minar::Scheduler::postCallback(validate_second).delay(minar::milliseconds(200));
+    return CaseTimeout(1000);
+}
+
+control_t third_case()
+{
+    sources[2] = Harness::get_current_case();
+    handler_count++;
+    minar::Scheduler::postCallback(fail_third).delay(minar::milliseconds(100));
+    return CaseTimeout(1000);
+}
+
+control_t timeout_case()
+{
+    sources[3] = Harness::get_current_case();
+    handler_count++;
+    return CaseTimeout(300);
+}
+
+status_t pipelined_teardown(const Case *const source, const size_t passed, const size_t failed, const failure_t failure)
+{
+    TEST_ASSERT_EQUAL(4, handler_count);
+    if (teardown_count < 4) teardown_order[teardown_count] = source - sources[0];
+    teardown_count++;
+    finish_ns = utest_v1_get_time_ns();
+    return greentea_case_teardown_handler(source, passed, failed, failure);
+}
+
+status_t pipelined_failure(const Case *const source, const failure_t failure)
+{
+    if (failure.reason == REASON_TIMEOUT && failure.location == LOCATION_CASE_HANDLER) timeout_count++;
+    // the failure raised by the callback is replayed once the test case is joined
+    else if (failure.reason == (REASON_ASSERTION | REASON_IGNORE) && teardown_count == 2) ignored_count++;
+    else return greentea_case_failure_continue_handler(source, failure);
+    greentea_case_failure_continue_handler(source, failure);
+    return STATUS_IGNORE;
+}
+
+void test_results()
+{
+    TEST_ASSERT_EQUAL(4, teardown_count);
+    for (int ii = 0; ii < 4; ii++) {
+        TEST_ASSERT_TRUE(sources[ii] == sources[0] + ii);
+        // the results are reported in declaration order
+        TEST_ASSERT_EQUAL(ii, teardown_order[ii]);
+    }
+    TEST_ASSERT_EQUAL(1, timeout_count);
+    TEST_ASSERT_EQUAL(1, ignored_count);
+    // the waits overlap, which one after the other would take 1100ms
+    TEST_ASSERT_TRUE(finish_ns - start_ns >= 300 * ms);
+    TEST_ASSERT_TRUE(finish_ns - start_ns < 600 * ms);
+}
+
+Case cases[] =
+{
+    Case("Overlapping the first wait", first_case, pipelined_teardown, pipelined_failure).with_attributes(CASE_ATTRIBUTE_OVERLAPPABLE),
+    Case("Overlapping a wait validated early", second_case, pipelined_teardown, pipelined_failure).with_attributes(CASE_ATTRIBUTE_OVERLAPPABLE),
+    Case("Overlapping a wait with a failure", third_case, pipelined_teardown, pipelined_failure).with_attributes(CASE_ATTRIBUTE_OVERLAPPABLE),
+    Case("Overlapping a wait timing out", timeout_case, pipelined_teardown, pipelined_failure).with_attributes(CASE_ATTRIBUTE_OVERLAPPABLE),
+    Case("Testing results", test_results)
+};
+
+status_t greentea_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(15, "default_auto");
+
+    return greentea_test_setup_handler(number_of_cases);
+};
+
+Specification specification(greentea_setup, cases, greentea_continue_handlers);
+
+void app_start(int, char*[])
+{
+    TEST_ASSERT_TRUE(Harness::set_pipelining(4));
+    Harness::run(specification);
+}
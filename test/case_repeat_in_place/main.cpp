@@ -0,0 +1,128 @@
+/****************************************************************************
+ * Copyright (c) 2016, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ****************************************************************************
+ */
+
+#include "greentea-client/test_env.h"
+#include "utest/utest.h"
+#include "unity/unity.h"
+
+using namespace utest::v1;
+
+static const size_t stress_iterations = 1000000;
+static const size_t failing_iterations = 1000;
+static size_t setup_count = 0;
+static size_t handler_count = 0;
+static size_t failure_count = 0;
+
+status_t count_setup(const Case *const source, const size_t index_of_case)
+{
+    setup_count++;
+    return greentea_case_setup_handler(source, index_of_case);
+}
+
+// --- STRESS ---
+control_t stress_case(const size_t call_count)
+{
+    handler_count++;
+    if (call_count != handler_count) TEST_ASSERT_EQUAL(handler_count, call_count);
+    return (call_count < stress_iterations) ? CaseRepeatHandler : CaseNoRepeat;
+}
+
+status_t stress_teardown(const Case *const source, const size_t passed, const size_t failed, const failure_t failure)
+{
+    TEST_ASSERT_EQUAL(1, setup_count);
+    TEST_ASSERT_EQUAL(stress_iterations, handler_count);
+    TEST_ASSERT_EQUAL(stress_iterations, passed);
+    TEST_ASSERT_EQUAL(0, failed);
+    return greentea_case_teardown_handler(source, passed, failed, failure);
+}
+
+// --- FAILURE ACCOUNTING ---
+control_t failing_case(const size_t call_count)
+{
+    if (call_count % 100 == 0) {
+        TEST_ASSERT_TRUE_MESSAGE(false, "expected failure");
+    }
+    return (call_count < failing_iterations) ? CaseRepeatHandler : CaseNoRepeat;
+}
+
+status_t ignore_failure(const Case *const, const failure_t failure)
+{
+    TEST_ASSERT_EQUAL(REASON_ASSERTION, failure.reason);
+    TEST_ASSERT_EQUAL(LOCATION_CASE_HANDLER, failure.location);
+    failure_count++;
+    return STATUS_IGNORE;
+}
+
+status_t failing_teardown(const Case *const source, const size_t passed, const size_t failed, const failure_t failure)
+{
+    TEST_ASSERT_EQUAL(2, setup_count);
+    TEST_ASSERT_EQUAL(failing_iterations / 100, failure_count);
+    // ignored failures do not fail an iteration
+    TEST_ASSERT_EQUAL(failing_iterations, passed);
+    TEST_ASSERT_EQUAL(0, failed);
+    return greentea_case_teardown_handler(source, passed, failed, failure);
+}
+
+status_t continue_failure(const Case *const, const failure_t failure)
+{
+    TEST_ASSERT_EQUAL(REASON_ASSERTION, failure.reason);
+    TEST_ASSERT_EQUAL(LOCATION_CASE_HANDLER, failure.location);
+    failure_count++;
+    return STATUS_CONTINUE;
+}
+
+status_t continuing_teardown(const Case *const source, const size_t passed, const size_t failed, const failure_t failure)
+{
+    TEST_ASSERT_EQUAL(3, setup_count);
+    TEST_ASSERT_EQUAL(2 * failing_iterations / 100, failure_count);
+    // every failed iteration is counted once, and only once
+    TEST_ASSERT_EQUAL(failing_iterations - failing_iterations / 100, passed);
+    TEST_ASSERT_EQUAL(failing_iterations / 100, failed);
+    return greentea_case_teardown_handler(source, passed, 0, failure_t(REASON_NONE));
+}
+
+Case cases[] =
+{
+    Case("Repeating the handler in place", count_setup, stress_case, stress_teardown),
+    Case("Repeating the handler with failures", count_setup, failing_case, failing_teardown, ignore_failure),
+    Case("Repeating the handler with continued failures", count_setup, failing_case, continuing_teardown, continue_failure)
+};
+
+status_t greentea_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(15, "default_auto");
+
+    return greentea_test_setup_handler(number_of_cases);
+};
+
+void greentea_teardown(const size_t passed, const size_t failed, const failure_t failure)
+{
+    TEST_ASSERT_EQUAL(2, passed);
+    TEST_ASSERT_EQUAL(1, failed);
+    TEST_ASSERT_EQUAL(REASON_CASES, failure.reason);
+
+    // pretend to greentea that the test was successful
+    greentea_test_teardown_handler(3, 0, REASON_NONE);
+}
+
+Specification specification(greentea_setup, cases, greentea_teardown, greentea_continue_handlers);
+
+void app_start(int, char*[])
+{
+    Harness::run(specification);
+}
@@ -0,0 +1,120 @@
+/****************************************************************************
+ * Copyright (c) 2016, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ****************************************************************************
+ */
+
+#include "mbed-drivers/mbed.h"
+#include "greentea-client/test_env.h"
+#include "utest/utest.h"
+#include "unity/unity.h"
+
+using namespace utest::v1;
+
+static const uint64_t ms = 1000000ull;
+static int warning_count = 0;
+
+void validate()
+{
+    Harness::validate_callback();
+}
+
+// --- CLOSE TO TIMEOUT ---
+control_t late_case()
+{
+    minar::Scheduler::postCallback(validate).delay(minar::milliseconds(950));
+    return CaseTimeout(1000);
+}
+
+status_t late_failure(const Case *const source, const failure_t failure)
+{
+    TEST_ASSERT_EQUAL(REASON_TIMEOUT_HEADROOM | REASON_IGNORE, failure.reason);
+    TEST_ASSERT_EQUAL(LOCATION_CASE_HANDLER, failure.location);
+    warning_count++;
+    return greentea_case_failure_continue_handler(source, failure);
+}
+
+status_t late_teardown(const Case *const source, const size_t passed, const size_t failed, const failure_t failure)
+{
+    const case_metrics_t metrics = Harness::get_case_metrics();
+    TEST_ASSERT_EQUAL(1, warning_count);
+    // the warning is ignored
+    TEST_ASSERT_EQUAL(1, passed);
+    TEST_ASSERT_EQUAL(0, failed);
+    TEST_ASSERT_EQUAL(1, metrics.callbacks);
+    TEST_ASSERT_TRUE(metrics.latency_max_ns >= 900 * ms);
+    TEST_ASSERT_TRUE(metrics.timeout_usage_max > 100 - UTEST_TIMEOUT_HEADROOM_PERCENT);
+    TEST_ASSERT_EQUAL(1, metrics.timeout_usage[9]);
+    return greentea_case_teardown_handler(source, passed, failed, failure);
+}
+
+// --- REPEATED CALLBACKS ---
+control_t early_case(const size_t call_count)
+{
+    minar::Scheduler::postCallback(validate).delay(minar::milliseconds(10));
+    return (call_count < 3) ? (CaseRepeatHandler + CaseTimeout(1000)) : CaseTimeout(1000);
+}
+
+status_t early_teardown(const Case *const source, const size_t passed, const size_t failed, const failure_t failure)
+{
+    const case_metrics_t metrics = Harness::get_case_metrics();
+    TEST_ASSERT_EQUAL(3, passed);
+    TEST_ASSERT_EQUAL(0, failed);
+    // the latencies of all repeats are aggregated
+    TEST_ASSERT_EQUAL(3, metrics.callbacks);
+    TEST_ASSERT_EQUAL(3, metrics.timeout_usage[0]);
+    TEST_ASSERT_TRUE(metrics.timeout_usage_max < 10);
+    // each wait starts just after its callback was posted, so it may be a little shorter than the delay
+    TEST_ASSERT_TRUE(metrics.wait_ns >= 3 * 9 * ms);
+    TEST_ASSERT_TRUE(metrics.wait_ns >= metrics.latency_max_ns);
+    return greentea_case_teardown_handler(source, passed, failed, failure);
+}
+
+void test_warnings()
+{
+    TEST_ASSERT_EQUAL(1, warning_count);
+}
+
+Case cases[] =
+{
+    Case("Validating close to the timeout", late_case, late_teardown, late_failure),
+    Case("Validating repeated callbacks early", early_case, early_teardown),
+    Case("Testing warnings", test_warnings)
+};
+
+status_t greentea_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(15, "default_auto");
+
+    return greentea_test_setup_handler(number_of_cases);
+};
+
+const handlers_t headroom_handlers = {
+    greentea_test_setup_handler,
+    greentea_test_teardown_handler,
+    greentea_test_failure_handler,
+    greentea_case_setup_handler,
+    greentea_case_teardown_handler,
+    greentea_case_failure_continue_handler,
+    verbose_case_benchmark_handler,
+    verbose_case_comparison_handler,
+    verbose_case_metrics_handler
+};
+Specification specification(greentea_setup, cases, headroom_handlers);
+
+void app_start(int, char*[])
+{
+    Harness::run(specification);
+}
@@ -0,0 +1,114 @@
+/****************************************************************************
+ * Copyright (c) 2016, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ****************************************************************************
+ */
+
+#include "greentea-client/test_env.h"
+#include "utest/utest.h"
+#include "unity/unity.h"
+#include "utest/crash_guard.h"
+
+using namespace utest::v1;
+
+// without the watchdog the test cases do not spin, in which case only the harness behavior is tested
+static bool has_watchdog = false;
+static volatile bool is_spinning = true;
+static int timeout_count = 0;
+static int teardown_count = 0;
+static uint64_t spin_ns[2] = {0, 0};
+
+// --- WATCHDOG ---
+static void spin(void *)
+{
+    while (is_spinning) ;
+}
+
+static void returning(void *)
+{
+}
+
+void test_guard()
+{
+    CrashGuard guard;
+    if (!has_watchdog) return;
+    // the watchdog of the function takes over the one of the harness
+    TEST_ASSERT_FALSE(guard.call(spin, NULL, 50));
+    TEST_ASSERT_TRUE(guard.has_timed_out());
+    TEST_ASSERT_TRUE(guard.call(returning, NULL, 50));
+}
+
+void spinning_case()
+{
+    if (has_watchdog) spin(NULL);
+}
+
+void returning_case()
+{
+}
+
+status_t timeout_failure(const Case *const source, const failure_t failure)
+{
+    TEST_ASSERT_EQUAL(REASON_TIMEOUT, failure.reason);
+    TEST_ASSERT_EQUAL(LOCATION_CASE_HANDLER, failure.location);
+    timeout_count++;
+    greentea_case_failure_continue_handler(source, failure);
+    return STATUS_IGNORE;
+}
+
+status_t spinning_teardown(const Case *const source, const size_t passed, const size_t failed, const failure_t failure)
+{
+    if (teardown_count < 2) spin_ns[teardown_count] = Harness::get_case_metrics().handler_ns;
+    teardown_count++;
+    return greentea_case_teardown_handler(source, passed, failed, failure);
+}
+
+void test_results()
+{
+    TEST_ASSERT_EQUAL(2, teardown_count);
+    if (!has_watchdog) {
+        TEST_ASSERT_EQUAL(0, timeout_count);
+        return;
+    }
+    TEST_ASSERT_EQUAL(2, timeout_count);
+    // the watchdog of the test case overrides the one of the harness
+    TEST_ASSERT_TRUE(spin_ns[0] >= 100000000ull && spin_ns[0] < 400000000ull);
+    TEST_ASSERT_TRUE(spin_ns[1] >= 400000000ull);
+}
+
+Case cases[] =
+{
+    Case("Interrupting a function", test_guard),
+    Case("Spinning in a case handler", spinning_case, spinning_teardown, timeout_failure).with_watchdog(100),
+    Case("Spinning under the watchdog of the harness", spinning_case, spinning_teardown, timeout_failure),
+    Case("Returning in time", returning_case, timeout_failure),
+    Case("Testing results", test_results)
+};
+
+status_t greentea_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(15, "default_auto");
+
+    return greentea_test_setup_handler(number_of_cases);
+};
+
+Specification specification(greentea_setup, cases, greentea_continue_handlers);
+
+void app_start(int, char*[])
+{
+    has_watchdog = Harness::set_watchdog(400);
+    TEST_ASSERT_EQUAL(UTEST_WATCHDOG_AVAILABLE, has_watchdog);
+    Harness::run(specification);
+}
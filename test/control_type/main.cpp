@@ -252,12 +252,31 @@ void test_different_group_combinations()
     ASSERT_CONTROL(CaseRepeatHandlerOnTimeout(42) + CaseRepeatAllOnTimeout(21), REPEAT_ALL_ON_TIMEOUT, 21);
 }
 
+void test_await_count_combinations()
+{
+    control_t c;
+
+    TEST_ASSERT_EQUAL(0, control_t().get_await_count());
+    TEST_ASSERT_EQUAL(0, CaseTimeout(42).get_await_count());
+    ASSERT_CONTROL(CaseAwaitCount(3, 42), REPEAT_UNDECLR, 42);
+    TEST_ASSERT_EQUAL(3, CaseAwaitCount(3, 42).get_await_count());
+
+    // the higher count and the lower timeout win
+    ASSERT_CONTROL(CaseAwaitCount(3, 42) + CaseTimeout(21), REPEAT_UNDECLR, 21);
+    TEST_ASSERT_EQUAL(3, (CaseAwaitCount(3, 42) + CaseTimeout(21)).get_await_count());
+    TEST_ASSERT_EQUAL(5, (CaseAwaitCount(3, 42) + CaseAwaitCount(5, 84)).get_await_count());
+    TEST_ASSERT_EQUAL(5, (CaseAwaitCount(5, 84) + CaseAwaitCount(3, 42)).get_await_count());
+    ASSERT_CONTROL(CaseAwaitCount(3, 42) + CaseRepeatHandler, REPEAT_HANDLER, 42);
+    TEST_ASSERT_EQUAL(3, (CaseRepeatHandler + CaseAwaitCount(3, 42)).get_await_count());
+}
+
 Case cases[] =
 {
     Case("Testing constructors", test_constructors),
     Case("Testing constants", test_constants),
     Case("Testing combinations of same group", test_same_group_combinations),
-    Case("Testing combinations of different group", test_different_group_combinations)
+    Case("Testing combinations of different group", test_different_group_combinations),
+    Case("Testing combinations with await counts", test_await_count_combinations)
 };
 
 status_t greentea_setup(const size_t number_of_cases)
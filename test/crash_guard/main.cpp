@@ -0,0 +1,132 @@
+/****************************************************************************
+ * Copyright (c) 2016, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ****************************************************************************
+ */
+
+#include "greentea-client/test_env.h"
+#include "utest/utest.h"
+#include "unity/unity.h"
+#include "utest/crash_guard.h"
+#include <signal.h>
+#include <stdlib.h>
+
+using namespace utest::v1;
+
+// without the crash guard the test cases do not crash, in which case only the harness behavior is tested
+static bool has_guard = false;
+static int crash_count = 0;
+static int teardown_count = 0;
+static int *volatile null_pointer = NULL;
+
+// --- CRASHES ---
+void test_guard()
+{
+    CrashGuard guard;
+    if (!guard.install()) return;
+    TEST_ASSERT_EQUAL(0, guard.get_signal());
+    TEST_ASSERT_FALSE(guard.call(reinterpret_cast<void (*)(void*)>(abort), NULL));
+    TEST_ASSERT_EQUAL(SIGABRT, guard.get_signal());
+}
+
+void segfault_case()
+{
+    if (has_guard) *null_pointer = 42;
+}
+
+void abort_case()
+{
+    if (has_guard) abort();
+}
+
+void signal_case()
+{
+    if (has_guard) raise(SIGFPE);
+}
+
+static size_t recurse(const size_t depth)
+{
+    volatile uint8_t frame[512];
+    if (depth == size_t(-1)) return 0;
+    frame[0] = uint8_t(depth);
+    return recurse(depth + 1) + frame[0];
+}
+
+void overflow_case()
+{
+    if (has_guard) recurse(0);
+}
+
+// the handlers of overlapped test cases are called ahead of their test case
+control_t overlapped_segfault_case()
+{
+    if (has_guard) *null_pointer = 42;
+    return CaseNext;
+}
+
+control_t overlapped_case()
+{
+    return CaseNext;
+}
+
+status_t crash_failure(const Case *const source, const failure_t failure)
+{
+    TEST_ASSERT_EQUAL(REASON_CRASH, failure.reason);
+    TEST_ASSERT_EQUAL(LOCATION_CASE_HANDLER, failure.location);
+    crash_count++;
+    greentea_case_failure_continue_handler(source, failure);
+    return STATUS_IGNORE;
+}
+
+status_t crash_teardown(const Case *const source, const size_t passed, const size_t failed, const failure_t failure)
+{
+    teardown_count++;
+    return greentea_case_teardown_handler(source, passed, failed, failure);
+}
+
+void test_results()
+{
+    TEST_ASSERT_EQUAL(6, teardown_count);
+    TEST_ASSERT_EQUAL(has_guard ? 5 : 0, crash_count);
+}
+
+Case cases[] =
+{
+    Case("Guarding a function", test_guard),
+    Case("Dereferencing a null pointer", segfault_case, crash_teardown, crash_failure),
+    Case("Aborting", abort_case, crash_teardown, crash_failure),
+    Case("Raising a signal", signal_case, crash_teardown, crash_failure),
+    Case("Overflowing the stack", overflow_case, crash_teardown, crash_failure),
+    Case("Crashing in an overlapped handler", overlapped_segfault_case, crash_teardown, crash_failure).with_attributes(CASE_ATTRIBUTE_OVERLAPPABLE),
+    Case("Overlapping a crashed handler", overlapped_case, crash_teardown, crash_failure).with_attributes(CASE_ATTRIBUTE_OVERLAPPABLE),
+    Case("Testing results", test_results)
+};
+
+status_t greentea_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(15, "default_auto");
+
+    return greentea_test_setup_handler(number_of_cases);
+};
+
+Specification specification(greentea_setup, cases, greentea_continue_handlers);
+
+void app_start(int, char*[])
+{
+    has_guard = Harness::set_crash_guard(true);
+    TEST_ASSERT_EQUAL(UTEST_CRASH_GUARD_AVAILABLE, has_guard);
+    Harness::set_pipelining(2);
+    Harness::run(specification);
+}
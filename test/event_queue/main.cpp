@@ -0,0 +1,180 @@
+/****************************************************************************
+ * Copyright (c) 2016, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ****************************************************************************
+ */
+
+#include "mbed-drivers/mbed.h"
+#include "greentea-client/test_env.h"
+#include "utest/utest.h"
+#include "utest/event_queue.h"
+#include "utest/worker_pool.h"
+#include "unity/unity.h"
+
+using namespace utest::v1;
+
+static const size_t producers = 40;
+static const size_t events_per_producer = 100;
+static const size_t failures_per_case = 8;
+static WorkerPool workers;
+static bool has_workers = false;
+static EventQueue shared_queue;
+static volatile size_t failures_handled = 0;
+static size_t scheduler_failures = 0;
+
+static EventQueue::event_t make_event(const uint64_t value)
+{
+    EventQueue::event_t event;
+    event.type = EventQueue::EVENT_FAILURE;
+    event.source = NULL;
+    event.reason = REASON_ASSERTION;
+    event.time_ns = value;
+    return event;
+}
+
+// --- QUEUE ---
+void test_fifo_and_overflow()
+{
+    EventQueue queue;
+    EventQueue::event_t event;
+    TEST_ASSERT_FALSE(queue.pop(event));
+
+    // the positions wrap around the slots several times
+    for (uint64_t round = 0; round < 3; round++) {
+        for (uint64_t ii = 0; ii < UTEST_EVENT_QUEUE_SIZE; ii++) {
+            TEST_ASSERT_TRUE(queue.push(make_event(round * 1000 + ii)));
+        }
+        TEST_ASSERT_FALSE(queue.push(make_event(0)));
+        for (uint64_t ii = 0; ii < UTEST_EVENT_QUEUE_SIZE; ii++) {
+            TEST_ASSERT_TRUE(queue.pop(event));
+            TEST_ASSERT_EQUAL(round * 1000 + ii, event.time_ns);
+        }
+        TEST_ASSERT_FALSE(queue.pop(event));
+    }
+
+    queue.push(make_event(1));
+    queue.clear();
+    TEST_ASSERT_FALSE(queue.pop(event));
+    TEST_ASSERT_TRUE(queue.push(make_event(2)));
+}
+
+void push_events(void *, const size_t index)
+{
+    for (size_t ii = 0; ii < events_per_producer; ii++) {
+        // the consumer frees up slots concurrently
+        while (!shared_queue.push(make_event(index * events_per_producer + ii))) ;
+    }
+}
+
+void test_concurrent_producers()
+{
+    if (!has_workers) return;
+
+    size_t next[producers] = {0};
+    TEST_ASSERT_TRUE(workers.dispatch(push_events, NULL, producers));
+    EventQueue::event_t event;
+    for (size_t received = 0; received < producers * events_per_producer; ) {
+        if (!shared_queue.pop(event)) continue;
+        // every event arrives exactly once and in the order of its producer
+        const size_t producer = size_t(event.time_ns / events_per_producer);
+        TEST_ASSERT_TRUE(producer < producers);
+        TEST_ASSERT_EQUAL(next[producer], event.time_ns % events_per_producer);
+        next[producer]++;
+        received++;
+    }
+    workers.wait_all();
+    TEST_ASSERT_FALSE(shared_queue.pop(event));
+}
+
+// --- FAILURES OF OTHER THREADS ---
+void raise_on_worker(void *, const size_t)
+{
+    Harness::raise_failure(REASON_ASSERTION);
+}
+
+status_t count_failure(const Case *const source, const failure_t failure)
+{
+    if (failure.reason == REASON_SCHEDULER) scheduler_failures++;
+    else if (failure.reason != REASON_ASSERTION) return greentea_case_failure_continue_handler(source, failure);
+    else failures_handled++;
+    return STATUS_IGNORE;
+}
+
+control_t worker_failures_case()
+{
+    failures_handled = 0;
+    if (has_workers) {
+        TEST_ASSERT_TRUE(workers.dispatch(raise_on_worker, NULL, failures_per_case));
+        workers.wait_all();
+        // the harness is busy executing this handler, so it has not handled the failures yet
+        TEST_ASSERT_EQUAL(0, failures_handled);
+    }
+    else {
+        for (size_t ii = 0; ii < failures_per_case; ii++) raise_on_worker(NULL, ii);
+    }
+    return CaseNext;
+}
+
+status_t worker_failures_teardown(const Case *const source, const size_t passed, const size_t failed, const failure_t failure)
+{
+    // the failures still belong to the test case that raised them
+    TEST_ASSERT_EQUAL(failures_per_case, failures_handled);
+    TEST_ASSERT_EQUAL(0, scheduler_failures);
+    return greentea_case_teardown_handler(source, passed, failed, failure);
+}
+
+control_t dropped_failures_case()
+{
+    failures_handled = 0;
+    if (has_workers) {
+        TEST_ASSERT_TRUE(workers.dispatch(raise_on_worker, NULL, UTEST_EVENT_QUEUE_SIZE + failures_per_case));
+        workers.wait_all();
+    }
+    return CaseNext;
+}
+
+status_t dropped_failures_teardown(const Case *const source, const size_t passed, const size_t failed, const failure_t failure)
+{
+    // the failures that did not fit into the queue are reported once
+    if (has_workers) {
+        TEST_ASSERT_EQUAL(UTEST_EVENT_QUEUE_SIZE, failures_handled);
+        TEST_ASSERT_EQUAL(1, scheduler_failures);
+    }
+    return greentea_case_teardown_handler(source, passed, failed, failure);
+}
+
+Case cases[] =
+{
+    Case("Testing FIFO order and overflow", test_fifo_and_overflow),
+    Case("Testing concurrent producers", test_concurrent_producers),
+    Case("Failures raised on worker threads", worker_failures_case, worker_failures_teardown, count_failure),
+    Case("Failures dropped by a full queue", dropped_failures_case, dropped_failures_teardown, count_failure)
+};
+
+status_t greentea_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(15, "default_auto");
+
+    return greentea_test_setup_handler(number_of_cases);
+};
+
+Specification specification(greentea_setup, cases, greentea_continue_handlers);
+
+void app_start(int, char*[])
+{
+    has_workers = workers.start(4);
+    TEST_ASSERT_EQUAL(UTEST_WORKER_POOL_AVAILABLE, has_workers);
+    Harness::run(specification);
+}
@@ -0,0 +1,154 @@
+/****************************************************************************
+ * Copyright (c) 2016, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ****************************************************************************
+ */
+
+#include "greentea-client/test_env.h"
+#include "utest/utest.h"
+#include "unity/unity.h"
+#include "utest/fork_server.h"
+#include <stdio.h>
+#include <string.h>
+
+using namespace utest::v1;
+
+// the fork server is not available on targets, in which case the test cases are skipped
+#if UTEST_FORK_SERVER_AVAILABLE
+
+#include <signal.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+
+static char path[64];
+static int server_pid = 0;
+static char output[2048];
+
+// --- SERVED SPECIFICATION ---
+static int fixture_loads = 0;
+static int fixture = 0;
+
+status_t load_fixture(const size_t number_of_cases)
+{
+    fixture_loads++;
+    fixture = 42;
+    return verbose_test_setup_handler(number_of_cases);
+}
+
+template< int N >
+void served_case()
+{
+    TEST_ASSERT_EQUAL(42, fixture);
+    printf("served case %d with %d fixture loads\n", N, fixture_loads);
+}
+
+Case served_cases[] = {
+    Case("Served case 0", served_case<0>),
+    Case("Served case 1", served_case<1>),
+    Case("Served case 2", served_case<2>)
+};
+Specification served_specification(load_fixture, served_cases, verbose_continue_handlers);
+
+// --- CLIENT ---
+void test_start_server()
+{
+    snprintf(path, sizeof(path), "/tmp/utest-fork-server-%d.sock", int(getpid()));
+    fflush(NULL);
+    server_pid = fork();
+    if (server_pid == 0) {
+        HarnessContext context;
+        _exit(context.serve(served_specification, path) ? 0 : 1);
+    }
+    TEST_ASSERT_TRUE(server_pid > 0);
+}
+
+void test_single_case()
+{
+    TEST_ASSERT_TRUE(ForkServer::request(path, 1, 1, output, sizeof(output)) > 0);
+    TEST_ASSERT_NULL(strstr(output, "served case 0"));
+    TEST_ASSERT_NOT_NULL(strstr(output, "served case 1 with 1 fixture loads"));
+    TEST_ASSERT_NULL(strstr(output, "served case 2"));
+    TEST_ASSERT_NOT_NULL(strstr(output, "1 passed, 0 failed"));
+}
+
+void test_remaining_cases()
+{
+    TEST_ASSERT_TRUE(ForkServer::request(path, 0, 0, output, sizeof(output)) > 0);
+    TEST_ASSERT_NOT_NULL(strstr(output, "served case 0 with 1 fixture loads"));
+    TEST_ASSERT_NOT_NULL(strstr(output, "served case 1 with 1 fixture loads"));
+    TEST_ASSERT_NOT_NULL(strstr(output, "served case 2 with 1 fixture loads"));
+    TEST_ASSERT_NOT_NULL(strstr(output, "3 passed, 0 failed"));
+}
+
+void test_idle_client()
+{
+    // this client connects, but never sends its request
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, path);
+    const int idle_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    TEST_ASSERT_TRUE(idle_fd >= 0);
+    TEST_ASSERT_EQUAL(0, connect(idle_fd, (struct sockaddr*) &address, sizeof(address)));
+
+    TEST_ASSERT_TRUE(ForkServer::request(path, 2, 1, output, sizeof(output)) > 0);
+    TEST_ASSERT_NOT_NULL(strstr(output, "served case 2 with 1 fixture loads"));
+    close(idle_fd);
+}
+
+void test_stop_server()
+{
+    TEST_ASSERT_EQUAL(0, kill(server_pid, SIGTERM));
+    int status = -1;
+    TEST_ASSERT_EQUAL(server_pid, waitpid(server_pid, &status, 0));
+    TEST_ASSERT_TRUE(WIFEXITED(status));
+    TEST_ASSERT_EQUAL(0, WEXITSTATUS(status));
+    // the stopped server removed its socket
+    TEST_ASSERT_EQUAL(-1, access(path, F_OK));
+}
+
+#else
+
+void test_start_server() {}
+void test_single_case() {}
+void test_remaining_cases() {}
+void test_idle_client() {}
+void test_stop_server() {}
+
+#endif
+
+Case cases[] =
+{
+    Case("Starting the fork server", test_start_server),
+    Case("Requesting a single case", test_single_case),
+    Case("Requesting all cases", test_remaining_cases),
+    Case("Requesting a case while another client is idle", test_idle_client),
+    Case("Stopping the fork server", test_stop_server)
+};
+
+status_t greentea_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(15, "default_auto");
+
+    return greentea_test_setup_handler(number_of_cases);
+};
+Specification specification(greentea_setup, cases, greentea_continue_handlers);
+
+void app_start(int, char*[])
+{
+    Harness::run(specification);
+}
@@ -0,0 +1,259 @@
+/****************************************************************************
+ * Copyright (c) 2016, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ****************************************************************************
+ */
+
+#include "greentea-client/test_env.h"
+#include "utest/utest.h"
+#include "unity/unity.h"
+
+using namespace utest::v1;
+
+// Each context needs its own scheduler instance, so this is a template over an instance number.
+// Callbacks are executed one at a time by `step()`, delayed callbacks are simply queued behind
+// the immediate ones, which is sufficient for validations arriving before their timeout.
+template< int N >
+struct manual_scheduler
+{
+    struct entry_t {
+        utest_v1_harness_callback_v2_t callback;
+        void *context;
+    };
+    static entry_t entries[16];
+    static size_t head;
+    static size_t tail;
+
+    static int32_t init() { head = tail = 0; return 0; }
+    static utest_v1_scheduler_handle_t post(const utest_v1_harness_callback_v2_t callback, void *context, const uint32_t) {
+        if (tail - head >= 16) return NULL;
+        entry_t &entry = entries[tail++ % 16];
+        entry.callback = callback;
+        entry.context = context;
+        return (utest_v1_scheduler_handle_t) &entry;
+    }
+    static int32_t cancel(utest_v1_scheduler_handle_t handle) {
+        ((entry_t*) handle)->callback = NULL;
+        return 0;
+    }
+    static int32_t run() { return 0; }
+    static size_t pending() {
+        size_t count = 0;
+        for (size_t ii = head; ii != tail; ii++) {
+            if (entries[ii % 16].callback) count++;
+        }
+        return count;
+    }
+    static bool step() {
+        if (head == tail) return false;
+        const entry_t entry = entries[head++ % 16];
+        if (entry.callback) entry.callback(entry.context);
+        return true;
+    }
+    static utest_v1_scheduler_v2_t get() {
+        const utest_v1_scheduler_v2_t scheduler = {UTEST_V1_SCHEDULER_VERSION_2, init, post, cancel, NULL, run};
+        return scheduler;
+    }
+};
+template< int N > typename manual_scheduler<N>::entry_t manual_scheduler<N>::entries[16];
+template< int N > size_t manual_scheduler<N>::head = 0;
+template< int N > size_t manual_scheduler<N>::tail = 0;
+
+static HarnessContext context_a;
+static HarnessContext context_b;
+static int call_order[32];
+static size_t call_count = 0;
+
+static void record(const int id) {
+    if (call_count < 32) call_order[call_count++] = id;
+}
+
+// --- SPECIFICATION A ---
+void context_a_pass() {
+    TEST_ASSERT_EQUAL_PTR(&context_a, &HarnessContext::get_current());
+    record(1);
+}
+void context_a_fail() {
+    record(1);
+    // this must only fail context A
+    TEST_ASSERT_TRUE_MESSAGE(false, "expected failure");
+}
+void context_a_validate(void *) {
+    context_a.validate_callback();
+}
+control_t context_a_async() {
+    record(1);
+    manual_scheduler<0>::post(context_a_validate, NULL, 10);
+    return CaseTimeout(100);
+}
+Case cases_a[] = {
+    Case("Context A passing", context_a_pass),
+    Case("Context A validation", context_a_async),
+    Case("Context A failing", context_a_fail)
+};
+Specification specification_a(cases_a, verbose_continue_handlers);
+
+// --- SPECIFICATION B ---
+void context_b_pass() {
+    TEST_ASSERT_EQUAL_PTR(&context_b, &HarnessContext::get_current());
+    TEST_ASSERT_TRUE(Harness::is_busy());
+    record(2);
+}
+void context_b_validate(void *) {
+    context_b.validate_callback();
+}
+control_t context_b_async() {
+    record(2);
+    manual_scheduler<1>::post(context_b_validate, NULL, 10);
+    return CaseTimeout(100);
+}
+Case cases_b[] = {
+    Case("Context B passing", context_b_pass),
+    Case("Context B validation", context_b_async),
+    Case("Context B passing again", context_b_pass)
+};
+Specification specification_b(cases_b, verbose_continue_handlers);
+
+// --- SPECIFICATION C ---
+status_t abort_on_failure(const Case *const, const failure_t) {
+    return STATUS_ABORT;
+}
+void context_c_never() {
+    record(3);
+}
+Case cases_c[] = {
+    Case("Context C passing", context_b_pass),
+    Case("Context C aborting", context_a_fail, abort_on_failure),
+    Case("Context C never run", context_c_never)
+};
+Specification specification_c(cases_c, verbose_continue_handlers);
+
+// --- SPECIFICATION D ---
+control_t context_d_await() {
+    return CaseTimeout(100);
+}
+Case cases_d[] = {
+    Case("Context D awaiting", context_d_await)
+};
+Specification specification_d(cases_d, verbose_continue_handlers);
+
+// --- OUTER SPECIFICATION ---
+void test_interleaved_contexts()
+{
+    TEST_ASSERT_EQUAL_PTR(&HarnessContext::get_default(), &HarnessContext::get_current());
+    TEST_ASSERT_TRUE(context_a.set_scheduler(manual_scheduler<0>::get()));
+    TEST_ASSERT_TRUE(context_b.set_scheduler(manual_scheduler<1>::get()));
+
+    TEST_ASSERT_TRUE(context_a.start(specification_a));
+    TEST_ASSERT_TRUE(context_b.start(specification_b));
+    TEST_ASSERT_TRUE(context_a.is_busy());
+    TEST_ASSERT_FALSE(context_a.start(specification_a));
+
+    // drive both event loops in lockstep
+    bool busy = true;
+    while (busy) {
+        busy  = manual_scheduler<0>::step();
+        busy |= manual_scheduler<1>::step();
+    }
+    TEST_ASSERT_FALSE(context_a.is_busy());
+    TEST_ASSERT_FALSE(context_b.is_busy());
+
+    // synchronous test cases follow each other directly, so the contexts interleave at the asynchronous cases
+    TEST_ASSERT_EQUAL(6, call_count);
+    TEST_ASSERT_EQUAL(1, call_order[1]);
+    TEST_ASSERT_EQUAL(2, call_order[2]);
+    TEST_ASSERT_EQUAL(2, call_order[3]);
+    TEST_ASSERT_EQUAL(1, call_order[4]);
+
+    TEST_ASSERT_EQUAL(2, context_a.get_passed());
+    TEST_ASSERT_EQUAL(1, context_a.get_failed());
+    TEST_ASSERT_EQUAL(REASON_CASES, context_a.get_failure().reason);
+    TEST_ASSERT_EQUAL(3, context_b.get_passed());
+    TEST_ASSERT_EQUAL(0, context_b.get_failed());
+    TEST_ASSERT_EQUAL(REASON_NONE, context_b.get_failure().reason);
+
+    // the outer context is current again
+    TEST_ASSERT_EQUAL_PTR(&HarnessContext::get_default(), &HarnessContext::get_current());
+}
+
+void test_restart_context()
+{
+    call_count = 0;
+    TEST_ASSERT_TRUE(context_b.start(specification_b));
+    while (manual_scheduler<1>::step()) ;
+    TEST_ASSERT_EQUAL(3, call_count);
+    TEST_ASSERT_EQUAL(3, context_b.get_passed());
+    TEST_ASSERT_EQUAL(0, context_b.get_failed());
+}
+
+void test_abort_context()
+{
+    call_count = 0;
+    TEST_ASSERT_TRUE(context_b.start(specification_c));
+    while (manual_scheduler<1>::step()) ;
+    TEST_ASSERT_FALSE(context_b.is_busy());
+    TEST_ASSERT_EQUAL(2, call_count);
+    TEST_ASSERT_EQUAL(1, context_b.get_passed());
+    TEST_ASSERT_EQUAL(1, context_b.get_failed());
+    TEST_ASSERT_EQUAL(REASON_ASSERTION, context_b.get_failure().reason);
+
+    // failures outside of a running context are ignored
+    context_b.raise_failure(REASON_ASSERTION);
+    TEST_ASSERT_EQUAL(1, context_b.get_failed());
+}
+
+void test_destroy_context()
+{
+    {
+        HarnessContext context;
+        TEST_ASSERT_TRUE(context.set_scheduler(manual_scheduler<2>::get()));
+        TEST_ASSERT_TRUE(context.start(specification_d));
+        TEST_ASSERT_EQUAL(1, manual_scheduler<2>::pending());
+    }
+    // the destroyed context canceled its first step
+    TEST_ASSERT_EQUAL(0, manual_scheduler<2>::pending());
+
+    {
+        HarnessContext context;
+        TEST_ASSERT_TRUE(context.set_scheduler(manual_scheduler<2>::get()));
+        TEST_ASSERT_TRUE(context.start(specification_d));
+        TEST_ASSERT_TRUE(manual_scheduler<2>::step());
+        TEST_ASSERT_TRUE(context.is_busy());
+        TEST_ASSERT_EQUAL(1, manual_scheduler<2>::pending());
+    }
+    // as well as the timeout of the awaiting test case
+    TEST_ASSERT_EQUAL(0, manual_scheduler<2>::pending());
+}
+
+Case cases[] =
+{
+    Case("Testing interleaved contexts", test_interleaved_contexts),
+    Case("Testing restarting a context", test_restart_context),
+    Case("Testing aborting a context", test_abort_context),
+    Case("Testing destroying a busy context", test_destroy_context)
+};
+
+status_t greentea_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(15, "default_auto");
+
+    return greentea_test_setup_handler(number_of_cases);
+};
+Specification specification(greentea_setup, cases, greentea_continue_handlers);
+
+void app_start(int, char*[])
+{
+    Harness::run(specification);
+}
@@ -0,0 +1,157 @@
+/****************************************************************************
+ * Copyright (c) 2016, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ****************************************************************************
+ */
+
+#include "greentea-client/test_env.h"
+#include "utest/utest.h"
+#include "unity/unity.h"
+#include "utest/heap_tracker.h"
+#include <stdlib.h>
+
+using namespace utest::v1;
+
+// without the heap tracker nothing is counted, in which case only the harness behavior is tested
+static const bool has_tracker = UTEST_HEAP_TRACKER_AVAILABLE;
+static void *volatile fixture = NULL;
+static void *volatile leaked = NULL;
+static int allocation_failures = 0;
+static case_metrics_t reports[4];
+static size_t report_count = 0;
+
+void record_metrics(const Case *const source, const case_metrics_t &metrics)
+{
+    verbose_case_metrics_handler(source, metrics);
+    if (report_count < 4) reports[report_count] = metrics;
+    report_count++;
+}
+
+// --- PHASES ---
+status_t phases_setup(const Case *const source, const size_t index_of_case)
+{
+    fixture = malloc(100);
+    return greentea_case_setup_handler(source, index_of_case);
+}
+
+void phases_case()
+{
+    for (int ii = 0; ii < 3; ii++) {
+        void *volatile block = malloc(1000);
+        free(block);
+    }
+}
+
+status_t phases_teardown(const Case *const source, const size_t passed, const size_t failed, const failure_t failure)
+{
+    const case_metrics_t metrics = Harness::get_case_metrics();
+    free(fixture);
+    if (has_tracker) {
+        TEST_ASSERT_EQUAL(1, metrics.setup_heap.allocations);
+        TEST_ASSERT_TRUE(metrics.setup_heap.bytes >= 100);
+        TEST_ASSERT_EQUAL(3, metrics.handler_heap.allocations);
+        TEST_ASSERT_TRUE(metrics.handler_heap.bytes >= 3000);
+        // the blocks were freed before the next one was allocated
+        TEST_ASSERT_TRUE(metrics.handler_heap.peak_bytes >= 1000 && metrics.handler_heap.peak_bytes < 2000);
+    }
+    return greentea_case_teardown_handler(source, passed, failed, failure);
+}
+
+// --- LEAKS ---
+void leaking_case()
+{
+    leaked = malloc(64);
+}
+
+// --- NO ALLOCATION ---
+static uint32_t accumulator = 0;
+
+void allocation_free_case()
+{
+    for (uint32_t ii = 0; ii < 1000; ii++) accumulator += ii;
+}
+
+void allocating_case()
+{
+    void *volatile block = malloc(16);
+    free(block);
+}
+
+status_t allocation_failure(const Case *const source, const failure_t failure)
+{
+    TEST_ASSERT_EQUAL(REASON_ALLOCATION, failure.reason);
+    TEST_ASSERT_EQUAL(LOCATION_CASE_HANDLER, failure.location);
+    allocation_failures++;
+    greentea_case_failure_continue_handler(source, failure);
+    return STATUS_IGNORE;
+}
+
+void test_results()
+{
+    free(leaked);
+    TEST_ASSERT_EQUAL(7, report_count);
+    if (!has_tracker) {
+        TEST_ASSERT_EQUAL(0, allocation_failures);
+        return;
+    }
+    // the allocations of the harness and of the parallel test cases do not fail the other test cases
+    TEST_ASSERT_EQUAL(2, allocation_failures);
+    // the fixture has been freed by the teardown
+    TEST_ASSERT_TRUE(reports[0].leaked_bytes == 0);
+    TEST_ASSERT_TRUE(reports[0].teardown_heap.allocations == 0);
+    TEST_ASSERT_TRUE(reports[1].leaked_bytes >= 64);
+    TEST_ASSERT_TRUE(reports[1].leaked_blocks == 1);
+    TEST_ASSERT_TRUE(reports[2].handler_heap.allocations == 0);
+    TEST_ASSERT_TRUE(reports[3].handler_heap.allocations == 1);
+}
+
+Case cases[] =
+{
+    Case("Allocating in the setup and handler", phases_setup, phases_case, phases_teardown),
+    Case("Leaking memory", leaking_case),
+    Case("Handler without allocations", allocation_free_case).with_attributes(CASE_ATTRIBUTE_NO_ALLOCATION),
+    Case("Allocating in a handler without allocations", allocating_case, allocation_failure).with_attributes(CASE_ATTRIBUTE_NO_ALLOCATION),
+    Case("Parallel handler without allocations", allocation_free_case).with_attributes(CASE_ATTRIBUTE_INDEPENDENT).with_attributes(CASE_ATTRIBUTE_NO_ALLOCATION),
+    Case("Allocating in a parallel handler without allocations", allocating_case, allocation_failure).with_attributes(CASE_ATTRIBUTE_INDEPENDENT).with_attributes(CASE_ATTRIBUTE_NO_ALLOCATION),
+    Case("Parallel handler without allocations again", allocation_free_case).with_attributes(CASE_ATTRIBUTE_INDEPENDENT).with_attributes(CASE_ATTRIBUTE_NO_ALLOCATION),
+    Case("Testing results", test_results)
+};
+
+status_t greentea_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(15, "default_auto");
+
+    return greentea_test_setup_handler(number_of_cases);
+};
+
+const handlers_t heap_handlers = {
+    greentea_test_setup_handler,
+    greentea_test_teardown_handler,
+    greentea_test_failure_handler,
+    greentea_case_setup_handler,
+    greentea_case_teardown_handler,
+    greentea_case_failure_continue_handler,
+    verbose_case_benchmark_handler,
+    verbose_case_comparison_handler,
+    record_metrics
+};
+Specification specification(greentea_setup, cases, heap_handlers);
+
+void app_start(int, char*[])
+{
+    // the workers are not available on targets, in which case the independent test cases run serially
+    Harness::set_workers(2);
+    Harness::run(specification);
+}
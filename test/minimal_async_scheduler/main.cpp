@@ -75,7 +75,8 @@ static int32_t utest_minimal_cancel(void *handle)
 static int32_t utest_minimal_run()
 {
     /* This is the amazing minimal scheduler.
-     * This is just a busy loop that calls the callbacks in this context.
+     * This is just a loop that calls the callbacks in this context
+     * and sleeps until the next interrupt otherwise.
      * THIS LOOP IS BLOCKING.
      */
     while(1)
@@ -91,6 +92,11 @@ static int32_t utest_minimal_run()
             // execute the copied callback
             callback();
         }
+        // sleep with interrupts disabled, so that the ticker interrupt cannot fire
+        // between checking the callback and going to sleep. A pending interrupt wakes up the core.
+        __disable_irq();
+        if (!minimal_callback) sleep();
+        __enable_irq();
     }
     return 0;
 }
@@ -0,0 +1,117 @@
+/****************************************************************************
+ * Copyright (c) 2016, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ****************************************************************************
+ */
+
+#include "greentea-client/test_env.h"
+#include "utest/utest.h"
+#include "unity/unity.h"
+
+using namespace utest::v1;
+
+static bool workers_started = false;
+static int running = 0;
+static int max_running = 0;
+static int failed_case = 0;
+static int failure_count = 0;
+static int teardown_order[8];
+static int teardown_count = 0;
+
+static int get_running()
+{
+    UTEST_ENTER_CRITICAL_SECTION;
+    const int value = running;
+    UTEST_LEAVE_CRITICAL_SECTION;
+    return value;
+}
+
+template< int N >
+void independent_case()
+{
+    {
+        UTEST_ENTER_CRITICAL_SECTION;
+        running++;
+        if (running > max_running) max_running = running;
+        UTEST_LEAVE_CRITICAL_SECTION;
+    }
+    // give the other workers the chance to pick up a test case
+    const uint64_t start = utest_v1_get_time_ns();
+    while (workers_started && get_running() < 2 && (utest_v1_get_time_ns() - start) < 500000000ull) ;
+
+    if (N == 3) {
+        failed_case = N;
+        TEST_ASSERT_TRUE_MESSAGE(false, "expected failure");
+    }
+    {
+        UTEST_ENTER_CRITICAL_SECTION;
+        running--;
+        UTEST_LEAVE_CRITICAL_SECTION;
+    }
+}
+
+template< int N >
+status_t independent_teardown(const Case *const source, const size_t passed, const size_t failed, const failure_t failure)
+{
+    if (teardown_count < 8) teardown_order[teardown_count++] = N;
+    return greentea_case_teardown_handler(source, passed, failed, failure);
+}
+
+status_t expected_failure(const Case *const, const failure_t failure)
+{
+    TEST_ASSERT_EQUAL(REASON_ASSERTION, failure.reason);
+    TEST_ASSERT_EQUAL(LOCATION_CASE_HANDLER, failure.location);
+    failure_count++;
+    return STATUS_IGNORE;
+}
+
+void test_results()
+{
+    TEST_ASSERT_EQUAL(6, teardown_count);
+    for (int ii = 0; ii < 6; ii++) {
+        TEST_ASSERT_EQUAL(ii + 1, teardown_order[ii]);
+    }
+    TEST_ASSERT_EQUAL(3, failed_case);
+    TEST_ASSERT_EQUAL(1, failure_count);
+    if (workers_started) {
+        TEST_ASSERT_TRUE(max_running >= 2);
+    }
+}
+
+Case cases[] =
+{
+    Case("Independent case 1", independent_case<1>, independent_teardown<1>).with_attributes(CASE_ATTRIBUTE_INDEPENDENT),
+    Case("Independent case 2", independent_case<2>, independent_teardown<2>).with_attributes(CASE_ATTRIBUTE_INDEPENDENT),
+    Case("Independent case 3", independent_case<3>, independent_teardown<3>, expected_failure).with_attributes(CASE_ATTRIBUTE_INDEPENDENT),
+    Case("Independent case 4", independent_case<4>, independent_teardown<4>).with_attributes(CASE_ATTRIBUTE_INDEPENDENT),
+    Case("Independent case 5", independent_case<5>, independent_teardown<5>).with_attributes(CASE_ATTRIBUTE_INDEPENDENT),
+    Case("Independent case 6", independent_case<6>, independent_teardown<6>).with_attributes(CASE_ATTRIBUTE_INDEPENDENT),
+    Case("Testing results in declaration order", test_results)
+};
+
+status_t greentea_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(15, "default_auto");
+
+    return greentea_test_setup_handler(number_of_cases);
+};
+Specification specification(greentea_setup, cases, greentea_continue_handlers);
+
+void app_start(int, char*[])
+{
+    // the workers are not available on targets, in which case the test cases run serially
+    workers_started = Harness::set_workers(4);
+    Harness::run(specification);
+}
@@ -0,0 +1,115 @@
+/****************************************************************************
+ * Copyright (c) 2016, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ****************************************************************************
+ */
+
+#include "greentea-client/test_env.h"
+#include "utest/utest.h"
+#include "unity/unity.h"
+#include "utest/perf_counters.h"
+
+using namespace utest::v1;
+
+// the counters may be unavailable, ie. inside a container or virtual machine, in which case they count nothing
+static bool has_counters = false;
+static volatile uint32_t accumulator = 0;
+static uint64_t loop_instructions = 0;
+
+// --- COUNTERS ---
+void test_counters()
+{
+    PerfCounters counters;
+    uint64_t counts[PERF_COUNTER_COUNT] = {0};
+
+    const bool is_open = counters.open();
+    counters.start();
+    for (uint32_t ii = 0; ii < 1000000; ii++) accumulator += ii;
+    counters.stop(counts);
+
+    if (!is_open) {
+        for (size_t ii = 0; ii < PERF_COUNTER_COUNT; ii++) TEST_ASSERT_TRUE(counts[ii] == 0);
+        return;
+    }
+    // every counter that is open counts the loop
+    const uint64_t loop = counts[PERF_INSTRUCTIONS];
+    counters.start();
+    for (uint32_t ii = 0; ii < 2000000; ii++) accumulator += ii;
+    counters.stop(counts);
+    TEST_ASSERT_TRUE(loop == 0 || counts[PERF_INSTRUCTIONS] - loop > loop);
+}
+
+// --- CASE HANDLER ---
+void loop_case()
+{
+    for (uint32_t ii = 0; ii < 1000000; ii++) accumulator += ii;
+}
+
+status_t loop_teardown(const Case *const source, const size_t passed, const size_t failed, const failure_t failure)
+{
+    const case_metrics_t metrics = Harness::get_case_metrics();
+    loop_instructions = metrics.perf_counts[PERF_INSTRUCTIONS];
+    if (!has_counters) {
+        for (size_t ii = 0; ii < PERF_COUNTER_COUNT; ii++) TEST_ASSERT_TRUE(metrics.perf_counts[ii] == 0);
+    }
+    // inside a virtual machine the instruction counter may be missing, even though other counters are available
+    else if (loop_instructions) {
+        TEST_ASSERT_TRUE(loop_instructions >= 1000000);
+    }
+    return greentea_case_teardown_handler(source, passed, failed, failure);
+}
+
+void empty_case() {}
+
+status_t empty_teardown(const Case *const source, const size_t passed, const size_t failed, const failure_t failure)
+{
+    // only the case handler is counted and the counts are reset for every test case
+    const case_metrics_t metrics = Harness::get_case_metrics();
+    TEST_ASSERT_TRUE(metrics.perf_counts[PERF_INSTRUCTIONS] <= loop_instructions / 10);
+    return greentea_case_teardown_handler(source, passed, failed, failure);
+}
+
+Case cases[] =
+{
+    Case("Counting a loop directly", test_counters),
+    Case("Counting a case handler", loop_case, loop_teardown),
+    Case("Counting an empty case handler", empty_case, empty_teardown)
+};
+
+status_t greentea_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(15, "default_auto");
+
+    return greentea_test_setup_handler(number_of_cases);
+};
+
+const handlers_t counter_handlers = {
+    greentea_test_setup_handler,
+    greentea_test_teardown_handler,
+    greentea_test_failure_handler,
+    greentea_case_setup_handler,
+    greentea_case_teardown_handler,
+    greentea_case_failure_continue_handler,
+    verbose_case_benchmark_handler,
+    verbose_case_comparison_handler,
+    verbose_case_metrics_handler
+};
+Specification specification(greentea_setup, cases, counter_handlers);
+
+void app_start(int, char*[])
+{
+    has_counters = Harness::set_perf_counters(true);
+    Harness::run(specification);
+}
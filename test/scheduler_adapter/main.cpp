@@ -0,0 +1,141 @@
+/****************************************************************************
+ * Copyright (c) 2016, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ****************************************************************************
+ */
+
+#include "mbed-drivers/mbed.h"
+#include "greentea-client/test_env.h"
+#include "utest/utest.h"
+#include "unity/unity.h"
+
+using namespace utest::v1;
+
+// a version 1 scheduler, whose posted callbacks are executed by the test and which may fail to cancel
+static utest_v1_harness_callback_t posted[16];
+static size_t posted_count = 0;
+static bool cancel_fails = false;
+
+// initializing drops all posted callbacks
+static int32_t fake_init()
+{
+    posted_count = 0;
+    return 0;
+}
+static void *fake_post(const utest_v1_harness_callback_t callback, const uint32_t)
+{
+    posted[posted_count] = callback;
+    return &posted[posted_count++];
+}
+static int32_t fake_cancel(void *handle)
+{
+    if (cancel_fails) return -1;
+    *static_cast<utest_v1_harness_callback_t*>(handle) = NULL;
+    return 0;
+}
+static int32_t fake_run() { return 0; }
+static const utest_v1_scheduler_t fake_scheduler = {fake_init, fake_post, fake_cancel, fake_run};
+
+static void *executed_context = NULL;
+static int context_a(1);
+static int context_b(2);
+static void callback(void *context)
+{
+    executed_context = context;
+}
+
+static void execute(const size_t index)
+{
+    if (posted[index]) posted[index]();
+}
+
+void test_failed_cancel()
+{
+    const utest_v1_scheduler_v2_t adapter = utest_v1_scheduler_adapt(fake_scheduler);
+    posted_count = 0;
+    executed_context = NULL;
+    TEST_ASSERT_EQUAL(0, adapter.init());
+
+    cancel_fails = true;
+    utest_v1_scheduler_handle_t handle = adapter.post(callback, &context_a, 100);
+    TEST_ASSERT_NOT_NULL(handle);
+    TEST_ASSERT_EQUAL(0, adapter.cancel(handle));
+    // the slot of the canceled callback is still reserved for its trampoline
+    TEST_ASSERT_NOT_NULL(adapter.post(callback, &context_b, 100));
+    TEST_ASSERT_TRUE(posted[0] != posted[1]);
+
+    // the stale trampoline does not execute the later callback
+    execute(0);
+    TEST_ASSERT_EQUAL_PTR(NULL, executed_context);
+    execute(1);
+    TEST_ASSERT_EQUAL_PTR(&context_b, executed_context);
+
+    // once its trampoline executed, the slot is free again
+    TEST_ASSERT_NOT_NULL(adapter.post(callback, &context_a, 100));
+    TEST_ASSERT_TRUE(posted[2] == posted[0]);
+    execute(2);
+    cancel_fails = false;
+}
+
+void test_successful_cancel()
+{
+    const utest_v1_scheduler_v2_t adapter = utest_v1_scheduler_adapt(fake_scheduler);
+    posted_count = 0;
+    executed_context = NULL;
+    TEST_ASSERT_EQUAL(0, adapter.init());
+
+    utest_v1_scheduler_handle_t handle = adapter.post(callback, &context_a, 100);
+    const utest_v1_harness_callback_t trampoline = posted[0];
+    TEST_ASSERT_EQUAL(0, adapter.cancel(handle));
+    // canceling twice fails
+    TEST_ASSERT_TRUE(adapter.cancel(handle) != 0);
+    // the slot is reused directly, since its trampoline will never execute
+    TEST_ASSERT_NOT_NULL(adapter.post(callback, &context_b, 100));
+    TEST_ASSERT_TRUE(posted[1] == trampoline);
+    execute(1);
+    TEST_ASSERT_EQUAL_PTR(&context_b, executed_context);
+}
+
+void test_reinit()
+{
+    const utest_v1_scheduler_v2_t adapter = utest_v1_scheduler_adapt(fake_scheduler);
+    // the trampolines dropped by every initialization must not keep their slots reserved
+    for (size_t ii = 0; ii <= UTEST_SCHEDULER_ADAPTER_SLOTS; ii++) {
+        TEST_ASSERT_EQUAL(0, adapter.init());
+        TEST_ASSERT_NOT_NULL(adapter.post(callback, &context_a, 100));
+    }
+    TEST_ASSERT_EQUAL(0, adapter.init());
+}
+
+Case cases[] =
+{
+    Case("Testing a failed cancellation", test_failed_cancel),
+    Case("Testing a successful cancellation", test_successful_cancel),
+    Case("Testing repeated initializations", test_reinit)
+};
+
+status_t greentea_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(15, "default_auto");
+
+    return greentea_test_setup_handler(number_of_cases);
+};
+
+Specification specification(greentea_setup, cases, greentea_continue_handlers);
+
+void app_start(int, char*[])
+{
+    Harness::run(specification);
+}
@@ -0,0 +1,88 @@
+/****************************************************************************
+ * Copyright (c) 2016, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ****************************************************************************
+ */
+
+#include "greentea-client/test_env.h"
+#include "utest/utest.h"
+#include "unity/unity.h"
+
+using namespace utest::v1;
+
+static utest_v1_scheduler_v2_t scheduler;
+static utest_v1_scheduler_handle_t expiring_handle = NULL;
+static uint64_t posted_ns = 0;
+static uint64_t delayed_ns = 0;
+static int canceled_calls = 0;
+
+// --- CANCELING A TIMER THAT EXPIRED TOGETHER WITH THE CURRENT ONE ---
+void delayed_callback(void *)
+{
+    delayed_ns = utest_v1_get_time_ns() - posted_ns;
+    Harness::validate_callback();
+}
+
+void canceled_callback(void *)
+{
+    canceled_calls++;
+}
+
+void canceling_callback(void *)
+{
+    TEST_ASSERT_EQUAL(0, scheduler.cancel(expiring_handle));
+    // the new timer may be allocated at the address of the canceled one
+    posted_ns = utest_v1_get_time_ns();
+    TEST_ASSERT_NOT_NULL(scheduler.post(delayed_callback, NULL, 100));
+}
+
+control_t test_cancel_in_batch()
+{
+    scheduler = utest_v1_get_scheduler_v2();
+    TEST_ASSERT_NOT_NULL(scheduler.post(canceling_callback, NULL, 10));
+    expiring_handle = scheduler.post(canceled_callback, NULL, 20);
+    TEST_ASSERT_NOT_NULL(expiring_handle);
+
+    // both timers expire before the harness returns to the scheduler, so they are handled in one batch
+    const uint64_t start = utest_v1_get_time_ns();
+    while (utest_v1_get_time_ns() - start < 50000000ull) ;
+    return CaseTimeout(1000);
+}
+
+status_t cancel_in_batch_teardown(const Case *const source, const size_t passed, const size_t failed, const failure_t failure)
+{
+    TEST_ASSERT_EQUAL(0, canceled_calls);
+    // the delayed callback must not execute in place of the canceled one
+    TEST_ASSERT_TRUE(delayed_ns >= 90000000ull);
+    return greentea_case_teardown_handler(source, passed, failed, failure);
+}
+
+Case cases[] =
+{
+    Case("Posting a timer after canceling an expired one", test_cancel_in_batch, cancel_in_batch_teardown)
+};
+
+status_t greentea_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(15, "default_auto");
+
+    return greentea_test_setup_handler(number_of_cases);
+};
+Specification specification(greentea_setup, cases, greentea_continue_handlers);
+
+void app_start(int, char*[])
+{
+    Harness::run(specification);
+}
@@ -0,0 +1,137 @@
+/****************************************************************************
+ * Copyright (c) 2016, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ****************************************************************************
+ */
+
+#include "greentea-client/test_env.h"
+#include "utest/utest.h"
+#include "unity/unity.h"
+#include "utest/stack_monitor.h"
+
+using namespace utest::v1;
+
+// without an alternate stack nothing is measured, in which case only the harness behavior is tested
+static bool has_monitor = false;
+static volatile uint8_t sink = 0;
+static int budget_failures = 0;
+static case_metrics_t reports[5];
+static size_t report_count = 0;
+
+void record_metrics(const Case *const source, const case_metrics_t &metrics)
+{
+    verbose_case_metrics_handler(source, metrics);
+    if (report_count < 5) reports[report_count] = metrics;
+    report_count++;
+}
+
+// --- PAINTING ---
+void test_painting()
+{
+    static uintptr_t region[64];
+    StackMonitor monitor;
+    monitor.attach(region, sizeof(region));
+    TEST_ASSERT_FALSE(monitor.is_executing());
+    TEST_ASSERT_EQUAL(0, monitor.get_peak());
+
+    monitor.paint();
+    TEST_ASSERT_EQUAL(0, monitor.get_peak());
+    // the stack grows down from the end of the region
+    region[60] = 0;
+    TEST_ASSERT_EQUAL(4 * sizeof(uintptr_t), monitor.get_peak());
+    region[10] = 0;
+    TEST_ASSERT_EQUAL(54 * sizeof(uintptr_t), monitor.get_peak());
+
+    monitor.paint();
+    TEST_ASSERT_EQUAL(0, monitor.get_peak());
+}
+
+// --- CASES ---
+void deep_case()
+{
+    volatile uint8_t buffer[16 * 1024];
+    for (size_t ii = 0; ii < sizeof(buffer); ii++) buffer[ii] = uint8_t(ii);
+    sink = buffer[100];
+}
+
+void shallow_case()
+{
+    volatile uint8_t buffer[64];
+    for (size_t ii = 0; ii < sizeof(buffer); ii++) buffer[ii] = uint8_t(ii);
+    sink = buffer[10];
+}
+
+status_t budget_failure(const Case *const source, const failure_t failure)
+{
+    TEST_ASSERT_EQUAL(REASON_STACK_BUDGET, failure.reason);
+    TEST_ASSERT_EQUAL(LOCATION_CASE_HANDLER, failure.location);
+    budget_failures++;
+    greentea_case_failure_continue_handler(source, failure);
+    return STATUS_IGNORE;
+}
+
+void test_results()
+{
+    TEST_ASSERT_EQUAL(5, report_count);
+    if (!has_monitor) {
+        for (size_t ii = 0; ii < 5; ii++) TEST_ASSERT_EQUAL(0, reports[ii].stack_peak_bytes);
+        TEST_ASSERT_EQUAL(0, budget_failures);
+        return;
+    }
+    // the harness frames are always on the stack
+    TEST_ASSERT_TRUE(reports[0].stack_peak_bytes > 0);
+    TEST_ASSERT_TRUE(reports[1].stack_peak_bytes >= 16 * 1024);
+    // the stack is painted again for every test case
+    TEST_ASSERT_TRUE(reports[2].stack_peak_bytes > 0 && reports[2].stack_peak_bytes < 16 * 1024);
+    TEST_ASSERT_TRUE(reports[3].stack_peak_bytes >= 16 * 1024);
+    TEST_ASSERT_EQUAL(1, budget_failures);
+}
+
+Case cases[] =
+{
+    Case("Painting a stack", test_painting),
+    Case("Using a lot of stack", deep_case),
+    Case("Using little stack", shallow_case),
+    Case("Exceeding the stack budget", deep_case, budget_failure).with_stack_budget(4 * 1024),
+    Case("Staying within the stack budget", shallow_case, budget_failure).with_stack_budget(64 * 1024),
+    Case("Testing results", test_results)
+};
+
+status_t greentea_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(15, "default_auto");
+
+    return greentea_test_setup_handler(number_of_cases);
+};
+
+const handlers_t stack_handlers = {
+    greentea_test_setup_handler,
+    greentea_test_teardown_handler,
+    greentea_test_failure_handler,
+    greentea_case_setup_handler,
+    greentea_case_teardown_handler,
+    greentea_case_failure_continue_handler,
+    verbose_case_benchmark_handler,
+    verbose_case_comparison_handler,
+    record_metrics
+};
+Specification specification(greentea_setup, cases, stack_handlers);
+
+void app_start(int, char*[])
+{
+    has_monitor = Harness::set_stack_monitor();
+    TEST_ASSERT_EQUAL(UTEST_ALTERNATE_STACK_AVAILABLE, has_monitor);
+    Harness::run(specification);
+}
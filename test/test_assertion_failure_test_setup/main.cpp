@@ -72,7 +72,10 @@ const handlers_t custom_handlers = {
     test_failure_handler,
     greentea_abort_handlers.case_setup,
     greentea_abort_handlers.case_teardown,
-    greentea_abort_handlers.case_failure
+    greentea_abort_handlers.case_failure,
+    greentea_abort_handlers.case_benchmark,
+    greentea_abort_handlers.case_comparison,
+    greentea_abort_handlers.case_metrics
 };
 
 Specification specification(failing_setup_handler, cases, custom_handlers);
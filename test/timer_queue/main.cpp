@@ -0,0 +1,148 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2013-2016 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "mbed-drivers/mbed.h"
+#include "greentea-client/test_env.h"
+#include "utest/utest.h"
+#include "utest/timer_queue.h"
+#include "unity/unity.h"
+
+using namespace utest::v1;
+
+static void callback_a() {}
+static void callback_b() {}
+static void callback_c() {}
+
+static int context_value(42);
+static void *callback_context(NULL);
+static void callback_v2(void *context) {
+    callback_context = context;
+}
+
+static utest_v1_harness_callback_t pop(TimerQueue &queue, const uint32_t now)
+{
+    TimerQueue::callback_t callback;
+    if (!queue.pop_expired(now, callback)) return NULL;
+    return callback.callback;
+}
+
+void test_ordering()
+{
+    TimerQueue queue;
+    TEST_ASSERT_TRUE(queue.is_empty());
+    TEST_ASSERT_EQUAL_PTR(NULL, pop(queue, 1000));
+
+    TEST_ASSERT_NOT_NULL(queue.insert(callback_c, 300));
+    TEST_ASSERT_NOT_NULL(queue.insert(callback_a, 100));
+    TEST_ASSERT_NOT_NULL(queue.insert(callback_b, 200));
+    TEST_ASSERT_EQUAL(100, queue.get_next_timestamp());
+
+    TEST_ASSERT_EQUAL_PTR(NULL, pop(queue, 99));
+    TEST_ASSERT_EQUAL_PTR(callback_a, pop(queue, 100));
+    TEST_ASSERT_EQUAL_PTR(callback_b, pop(queue, 1000));
+    TEST_ASSERT_EQUAL_PTR(callback_c, pop(queue, 1000));
+    TEST_ASSERT_TRUE(queue.is_empty());
+}
+
+void test_fifo_and_overflow()
+{
+    TimerQueue queue;
+    // equal timestamps are returned in insertion order
+    queue.insert(callback_a, 0);
+    queue.insert(callback_b, 0);
+    queue.insert(callback_c, 0);
+    TEST_ASSERT_EQUAL_PTR(callback_a, pop(queue, 0));
+    TEST_ASSERT_EQUAL_PTR(callback_b, pop(queue, 0));
+    TEST_ASSERT_EQUAL_PTR(callback_c, pop(queue, 0));
+
+    // timestamps are compared modulo overflow
+    queue.insert(callback_b, 0x10);
+    queue.insert(callback_a, 0xfffffff0);
+    TEST_ASSERT_EQUAL_PTR(callback_a, pop(queue, 0xfffffff0));
+    TEST_ASSERT_EQUAL_PTR(NULL, pop(queue, 0xfffffff8));
+    TEST_ASSERT_EQUAL_PTR(callback_b, pop(queue, 0x10));
+}
+
+void test_cancel()
+{
+    TimerQueue queue;
+    void *handle_a = queue.insert(callback_a, 100);
+    void *handle_b = queue.insert(callback_b, 200);
+    queue.insert(callback_c, 300);
+
+    TEST_ASSERT_TRUE(queue.cancel(handle_b));
+    // canceling twice has no effect
+    TEST_ASSERT_FALSE(queue.cancel(handle_b));
+    TEST_ASSERT_FALSE(queue.cancel(NULL));
+
+    TEST_ASSERT_EQUAL_PTR(callback_a, pop(queue, 1000));
+    // the handle of an executed callback is invalid, even if its slot is reused
+    void *handle_reused = queue.insert(callback_b, 400);
+    TEST_ASSERT_FALSE(queue.cancel(handle_a));
+    TEST_ASSERT_EQUAL_PTR(callback_c, pop(queue, 1000));
+    TEST_ASSERT_TRUE(queue.cancel(handle_reused));
+    TEST_ASSERT_TRUE(queue.is_empty());
+}
+
+void test_context()
+{
+    TimerQueue queue;
+    queue.insert(callback_v2, &context_value, 100);
+    queue.insert(callback_a, 50);
+
+    TimerQueue::callback_t callback;
+    TEST_ASSERT_TRUE(queue.pop_expired(100, callback));
+    TEST_ASSERT_EQUAL_PTR(callback_a, callback.callback);
+    TEST_ASSERT_TRUE(queue.pop_expired(100, callback));
+    TEST_ASSERT_EQUAL_PTR(NULL, callback.callback);
+    callback();
+    TEST_ASSERT_EQUAL_PTR(&context_value, callback_context);
+}
+
+void test_capacity()
+{
+    TimerQueue queue;
+    for (uint32_t ii = 0; ii < UTEST_TIMER_QUEUE_SIZE; ii++) {
+        TEST_ASSERT_NOT_NULL(queue.insert(callback_a, UTEST_TIMER_QUEUE_SIZE - ii));
+    }
+    TEST_ASSERT_EQUAL_PTR(NULL, queue.insert(callback_a, 0));
+    for (uint32_t ii = 0; ii < UTEST_TIMER_QUEUE_SIZE; ii++) {
+        TEST_ASSERT_EQUAL(ii + 1, queue.get_next_timestamp());
+        TEST_ASSERT_EQUAL_PTR(callback_a, pop(queue, ii + 1));
+    }
+    TEST_ASSERT_TRUE(queue.is_empty());
+}
+
+Case cases[] =
+{
+    Case("Testing ordering", test_ordering),
+    Case("Testing FIFO order and overflow", test_fifo_and_overflow),
+    Case("Testing cancellation", test_cancel),
+    Case("Testing context callbacks", test_context),
+    Case("Testing capacity", test_capacity)
+};
+
+status_t greentea_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(15, "default_auto");
+
+    return greentea_test_setup_handler(number_of_cases);
+};
+Specification specification(greentea_setup, cases, greentea_continue_handlers);
+
+void app_start(int, char*[])
+{
+    Harness::run(specification);
+}
@@ -0,0 +1,138 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2013-2016 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "mbed-drivers/mbed.h"
+#include "greentea-client/test_env.h"
+#include "utest/utest.h"
+#include "utest/virtual_scheduler.h"
+#include "unity/unity.h"
+
+using namespace utest::v1;
+
+utest_v1_scheduler_t scheduler;
+int call_counter(0);
+uint64_t real_start(0);
+
+// Timeout (Failure) --------------------------------------------------------------------------------------------------
+control_t timeout_failure_case()
+{
+    TEST_ASSERT_EQUAL(0, call_counter++);
+    TEST_ASSERT_EQUAL(0, utest_v1_get_virtual_time_us());
+    return CaseTimeout(500);
+}
+status_t timeout_failure_case_failure_handler(const Case *const source, const failure_t failure)
+{
+    TEST_ASSERT_EQUAL(1, call_counter++);
+    TEST_ASSERT_EQUAL(REASON_TIMEOUT, failure.reason);
+    TEST_ASSERT_EQUAL(500000, utest_v1_get_virtual_time_us());
+    // ignore the timeout, since this is a test
+    return greentea_case_failure_continue_handler(source, failure.ignored());
+}
+
+// Timeout (Success) --------------------------------------------------------------------------------------------------
+void timeout_success_case_validate()
+{
+    TEST_ASSERT_EQUAL(3, call_counter++);
+    TEST_ASSERT_EQUAL(600000, utest_v1_get_virtual_time_us());
+    Harness::validate_callback();
+}
+control_t timeout_success_case()
+{
+    TEST_ASSERT_EQUAL(2, call_counter++);
+    scheduler.post(timeout_success_case_validate, 100);
+    return CaseTimeout(200);
+}
+
+// RepeatHandlerOnTimeout ---------------------------------------------------------------------------------------------
+void repeat_handler_on_timeout_case_validate()
+{
+    TEST_ASSERT_EQUAL(9, call_counter++);
+    TEST_ASSERT_EQUAL(1050000, utest_v1_get_virtual_time_us());
+    Harness::validate_callback();
+}
+control_t repeat_handler_on_timeout_case(const size_t call_count)
+{
+    TEST_ASSERT_EQUAL(call_count + 3, call_counter++);
+    TEST_ASSERT_EQUAL(600000 + (call_count - 1) * 100000, utest_v1_get_virtual_time_us());
+    if (call_count == 5) {
+        scheduler.post(repeat_handler_on_timeout_case_validate, 50);
+    }
+    return CaseRepeatHandlerOnTimeout(100);
+}
+
+// Long Timeout -------------------------------------------------------------------------------------------------------
+static const uint64_t two_hours_us = 2ull * 3600 * 1000000;
+void long_timeout_case_validate()
+{
+    TEST_ASSERT_EQUAL(11, call_counter++);
+    TEST_ASSERT_TRUE(1050000 + two_hours_us == utest_v1_get_virtual_time_us());
+    Harness::validate_callback();
+}
+control_t long_timeout_case()
+{
+    TEST_ASSERT_EQUAL(10, call_counter++);
+    // the deadlines exceed the range of a 32bit microsecond clock
+    scheduler.post(long_timeout_case_validate, 2 * 3600 * 1000);
+    return CaseTimeout(3 * 3600 * 1000);
+}
+
+// Cases --------------------------------------------------------------------------------------------------------------
+Case cases[] = {
+    Case("Virtual Time: Timeout (Failure)", timeout_failure_case, timeout_failure_case_failure_handler),
+    Case("Virtual Time: Timeout (Success)", timeout_success_case),
+    Case("Virtual Time: RepeatHandlerOnTimeout", repeat_handler_on_timeout_case),
+    Case("Virtual Time: Long Timeout", long_timeout_case)
+};
+
+// Specification: Setup & Teardown ------------------------------------------------------------------------------------
+status_t greentea_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(15, "default_auto");
+    real_start = utest_v1_get_time_ns();
+    return greentea_test_setup_handler(number_of_cases);
+}
+void greentea_teardown(const size_t passed, const size_t failed, const failure_t failure)
+{
+    TEST_ASSERT_EQUAL(12, call_counter++);
+    TEST_ASSERT_EQUAL(4, passed);
+    TEST_ASSERT_EQUAL(0, failed);
+    TEST_ASSERT_EQUAL(REASON_NONE, failure.reason);
+    TEST_ASSERT_TRUE(1050000 + two_hours_us == utest_v1_get_virtual_time_us());
+    // the timeouts were skipped
+    TEST_ASSERT_TRUE((utest_v1_get_time_ns() - real_start) / 1000 < utest_v1_get_virtual_time_us());
+    greentea_test_teardown_handler(passed, failed, failure);
+}
+
+const handlers_t virtual_time_handlers = {
+    greentea_test_setup_handler,
+    greentea_test_teardown_handler,
+    greentea_test_failure_handler,
+    virtual_time_case_setup_handler,
+    virtual_time_case_teardown_handler,
+    greentea_case_failure_continue_handler,
+    verbose_case_benchmark_handler,
+    verbose_case_comparison_handler,
+    ignore_handler
+};
+
+Specification specification(greentea_setup, cases, greentea_teardown, virtual_time_handlers);
+
+void app_start(int, char*[])
+{
+    scheduler = utest_v1_get_virtual_scheduler(utest_v1_get_scheduler());
+    // You MUST set the virtual scheduler before running the specification.
+    Harness::set_scheduler(scheduler);
+    Harness::run(specification);
+}
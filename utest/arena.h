@@ -0,0 +1,89 @@
+/****************************************************************************
+ * Copyright (c) 2016, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ****************************************************************************
+ */
+
+#ifndef UTEST_ARENA_H
+#define UTEST_ARENA_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifndef UTEST_HUGE_PAGES_AVAILABLE
+#   if defined(__GNUC__) && defined(__linux__)
+#       define UTEST_HUGE_PAGES_AVAILABLE 1
+#   else
+#       define UTEST_HUGE_PAGES_AVAILABLE 0
+#   endif
+#endif
+
+namespace utest {
+namespace v1 {
+
+    /** Bump allocator of a fixed size block of memory.
+     *
+     * Allocating only advances an offset into the block and nothing is freed individually,
+     * instead `reset()` releases all allocations at once.
+     *
+     * On Linux hosts the block can be backed by huge pages, which are taken from the reserved huge pages
+     * if possible and otherwise requested as transparent huge pages.
+     *
+     * @note The arena is not thread-safe.
+     */
+    class Arena
+    {
+    public:
+        Arena();
+        /// Releases the block.
+        ~Arena();
+
+        /// Allocates a block of `size` bytes, releasing the previous block.
+        /// @returns `false` if the block could not be allocated
+        bool reserve(const size_t size, const bool huge_pages = false);
+
+        /// Releases the block.
+        void release();
+
+        /// @returns `size` bytes aligned to `alignment`, which must be a power of two,
+        ///          or `NULL` if the block does not have enough space left
+        void *allocate(const size_t size, const size_t alignment = 16);
+
+        /// Releases all allocations.
+        void reset() { used = 0; }
+
+        /// @returns the number of bytes allocated since the last reset, including alignment padding
+        size_t get_used() const { return used; }
+        /// @returns the size of the block
+        size_t get_size() const { return capacity; }
+        /// @returns `true` if the block is backed by reserved huge pages or the kernel accepted it for transparent huge pages
+        bool has_huge_pages() const { return is_huge; }
+
+    private:
+        Arena(const Arena&);
+        Arena &operator=(const Arena&);
+
+        uint8_t *block;
+        size_t capacity;
+        size_t used;
+        size_t mapping_size;    ///< the size of the mapping, if the block has been mapped instead of allocated from the heap
+        bool is_huge;
+    };
+
+}   // namespace v1
+}   // namespace utest
+
+#endif // UTEST_ARENA_H
@@ -0,0 +1,106 @@
+/****************************************************************************
+ * Copyright (c) 2016, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ****************************************************************************
+ */
+
+#ifndef UTEST_ATOMIC_H
+#define UTEST_ATOMIC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "shim.h"
+
+#ifndef UTEST_ATOMIC_AVAILABLE
+#   if defined(__GNUC__) && (defined(__linux__) || defined(__APPLE__))
+#       define UTEST_ATOMIC_AVAILABLE 1
+#   else
+#       define UTEST_ATOMIC_AVAILABLE 0
+#   endif
+#endif
+
+namespace utest {
+namespace v1 {
+
+    /* Atomic operations on the run state, which callbacks modify from other threads or interrupts.
+     *
+     * Hosts use the `__sync` builtins of the compiler, which are full barriers.
+     * Targets without them, or without 64-bit atomics like most Cortex-M cores, use a critical section instead.
+     */
+
+    /// Adds `value` to `target`.
+    /// @returns the new value of `target`
+    template <typename T>
+    inline T atomic_add(volatile T &target, const T value)
+    {
+#if UTEST_ATOMIC_AVAILABLE
+        return __sync_add_and_fetch(&target, value);
+#else
+        T result;
+        {
+            UTEST_ENTER_CRITICAL_SECTION;
+            result = (target += value);
+            UTEST_LEAVE_CRITICAL_SECTION;
+        }
+        return result;
+#endif
+    }
+
+    /// Stores `desired` in `target`, if `target` contains `expected`.
+    /// @returns `true` if `desired` has been stored
+    template <typename T>
+    inline bool atomic_compare_exchange(volatile T &target, const T expected, const T desired)
+    {
+#if UTEST_ATOMIC_AVAILABLE
+        return __sync_bool_compare_and_swap(&target, expected, desired);
+#else
+        bool result = false;
+        {
+            UTEST_ENTER_CRITICAL_SECTION;
+            if (target == expected) {
+                target = desired;
+                result = true;
+            }
+            UTEST_LEAVE_CRITICAL_SECTION;
+        }
+        return result;
+#endif
+    }
+
+    /// Orders all memory accesses before the call before all memory accesses after it.
+    inline void atomic_fence()
+    {
+#if UTEST_ATOMIC_AVAILABLE
+        __sync_synchronize();
+#else
+        UTEST_ENTER_CRITICAL_SECTION;
+        UTEST_LEAVE_CRITICAL_SECTION;
+#endif
+    }
+
+    /// Raises `target` to `value`, if it is smaller.
+    template <typename T>
+    inline void atomic_max(volatile T &target, const T value)
+    {
+        for (T current = target; current < value; current = target) {
+            if (atomic_compare_exchange(target, current, value)) return;
+        }
+    }
+
+}   // namespace v1
+}   // namespace utest
+
+#endif // UTEST_ATOMIC_H
@@ -0,0 +1,186 @@
+/****************************************************************************
+ * Copyright (c) 2016, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ****************************************************************************
+ */
+
+#ifndef UTEST_BENCHMARK_H
+#define UTEST_BENCHMARK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include "types.h"
+
+#ifndef UTEST_BENCHMARK_SAMPLES
+#   ifdef YOTTA_CFG_UTEST_BENCHMARK_SAMPLES
+#       define UTEST_BENCHMARK_SAMPLES YOTTA_CFG_UTEST_BENCHMARK_SAMPLES
+#   else
+#       define UTEST_BENCHMARK_SAMPLES 30
+#   endif
+#endif
+
+#ifndef UTEST_BENCHMARK_WARMUP_SAMPLES
+#   ifdef YOTTA_CFG_UTEST_BENCHMARK_WARMUP_SAMPLES
+#       define UTEST_BENCHMARK_WARMUP_SAMPLES YOTTA_CFG_UTEST_BENCHMARK_WARMUP_SAMPLES
+#   else
+#       define UTEST_BENCHMARK_WARMUP_SAMPLES 3
+#   endif
+#endif
+
+#ifndef UTEST_BENCHMARK_SAMPLE_US
+#   ifdef YOTTA_CFG_UTEST_BENCHMARK_SAMPLE_US
+#       define UTEST_BENCHMARK_SAMPLE_US YOTTA_CFG_UTEST_BENCHMARK_SAMPLE_US
+#   else
+#       define UTEST_BENCHMARK_SAMPLE_US 10000
+#   endif
+#endif
+
+#ifndef UTEST_BENCHMARK_CONFIDENCE_PERMILLE
+#   ifdef YOTTA_CFG_UTEST_BENCHMARK_CONFIDENCE_PERMILLE
+#       define UTEST_BENCHMARK_CONFIDENCE_PERMILLE YOTTA_CFG_UTEST_BENCHMARK_CONFIDENCE_PERMILLE
+#   else
+#       define UTEST_BENCHMARK_CONFIDENCE_PERMILLE 999
+#   endif
+#endif
+
+#ifndef UTEST_BENCHMARK_TOLERANCE_PERCENT
+#   ifdef YOTTA_CFG_UTEST_BENCHMARK_TOLERANCE_PERCENT
+#       define UTEST_BENCHMARK_TOLERANCE_PERCENT YOTTA_CFG_UTEST_BENCHMARK_TOLERANCE_PERCENT
+#   else
+#       define UTEST_BENCHMARK_TOLERANCE_PERCENT 5
+#   endif
+#endif
+
+namespace utest {
+namespace v1 {
+
+    /** Measurement and statistics of benchmark test cases.
+     *
+     * The harness calibrates the number of iterations of a benchmark handler with `calibrate()`, until
+     * one call takes at least `UTEST_BENCHMARK_SAMPLE_US`.
+     * It then discards `UTEST_BENCHMARK_WARMUP_SAMPLES` calls, measures `UTEST_BENCHMARK_SAMPLES` calls
+     * and reports their statistics computed by `evaluate()`.
+     */
+    class Benchmark
+    {
+    public:
+        /// @returns the time in nanoseconds it took to call `handler` with `iterations`
+        static uint64_t measure(const case_benchmark_handler_t handler, const size_t iterations);
+
+        /** Estimates the number of iterations needed for a sample of `target_ns`.
+         *
+         * @param iterations    the number of iterations of the last measurement
+         * @param elapsed_ns    the time the last measurement took
+         * @returns the next number of iterations to measure, or zero if the last measurement reached the target
+         */
+        static size_t calibrate(const size_t iterations, const uint64_t elapsed_ns, const uint64_t target_ns);
+
+        /// Sorts the samples and computes their statistics.
+        /// @param sample_ns    the time per iteration of every sample
+        static benchmark_result_t evaluate(double *sample_ns, const size_t count, const size_t iterations);
+
+        /** One-sided Mann-Whitney U test, whether the samples tend to be slower than the baseline samples.
+         *
+         * Both sets of samples must be sorted in ascending order.
+         * @returns the p-value of the normal approximation of the test, with correction for ties
+         */
+        static double compare(const double *sample_ns, const size_t count, const double *baseline_ns, const size_t baseline_count);
+    };
+
+    /** Paired measurement of a candidate and a baseline benchmark handler.
+     *
+     * Every block measures one sample of both handlers directly after each other in random order,
+     * so that slow drifts of the system, like thermal throttling or frequency scaling, affect both
+     * handlers alike and cancel out in the ratio of the block.
+     */
+    class BenchmarkComparison
+    {
+    public:
+        BenchmarkComparison();
+
+        /// Discards all blocks and sets the calibrated iterations of both handlers.
+        void reset(const size_t baseline_iterations, const size_t candidate_iterations, const uint32_t seed);
+
+        /// Measures one block.
+        void measure(const case_benchmark_handler_t baseline_handler, const case_benchmark_handler_t candidate_handler);
+
+        /// @returns the number of measured blocks
+        size_t get_blocks() const;
+
+        /// Computes the ratio of all measured blocks and its confidence interval.
+        /// This sorts the samples of each handler, so no more blocks may be measured afterwards.
+        benchmark_comparison_t evaluate();
+
+    private:
+        size_t iterations[2];
+        double sample_ns[2][UTEST_BENCHMARK_SAMPLES];
+        size_t blocks;
+        uint32_t random;
+    };
+
+    /** Baseline samples of benchmark test cases, keyed by their description.
+     *
+     * A baseline file contains one line per test case with the description, a tab and the
+     * time per iteration of every sample separated by spaces.
+     * Lines starting with `#` are ignored.
+     */
+    class BenchmarkBaseline
+    {
+    public:
+        BenchmarkBaseline();
+        ~BenchmarkBaseline();
+
+        /** Loads the baseline file `load_path` and truncates the file `save_path`.
+         *
+         * Either path may be `NULL` and both paths may name the same file, so that it is updated.
+         * @returns `false` if a file could not be opened
+         */
+        bool open(const char *load_path, const char *save_path);
+
+        /// Releases the loaded baseline and closes the saved baseline.
+        void close();
+
+        /// Copies the baseline samples of a test case into `sample_ns` in ascending order.
+        /// If there are more than `size` baseline samples, evenly spaced samples are chosen.
+        /// @returns the number of samples, or zero if there is no baseline for this test case
+        size_t load(const char *description, double *sample_ns, const size_t size) const;
+
+        /// Appends the samples of a test case to the saved baseline file.
+        void save(const char *description, const benchmark_result_t result);
+
+        /** Compares the samples of a test case with its baseline.
+         *
+         * The test case regressed, if its median is more than `UTEST_BENCHMARK_TOLERANCE_PERCENT` slower
+         * than the baseline median and the samples are slower with a confidence of
+         * `UTEST_BENCHMARK_CONFIDENCE_PERMILLE`.
+         */
+        bool is_regression(const char *description, const benchmark_result_t result) const;
+
+    private:
+        BenchmarkBaseline(const BenchmarkBaseline&);
+        BenchmarkBaseline &operator=(const BenchmarkBaseline&);
+
+        const char *find(const char *description) const;
+
+        char *loaded;       ///< contents of the loaded baseline file
+        FILE *saved;
+    };
+
+}   // namespace v1
+}   // namespace utest
+
+#endif // UTEST_BENCHMARK_H
@@ -101,6 +101,41 @@ namespace v1 {
             const case_teardown_handler_t teardown_handler,
             const case_failure_handler_t failure_handler = default_handler);
 
+        // overloads for case_benchmark_handler_t
+        Case(const char *description,
+             const case_setup_handler_t setup_handler,
+             const case_benchmark_handler_t case_handler,
+             const case_teardown_handler_t teardown_handler = default_handler,
+             const case_failure_handler_t failure_handler = default_handler);
+
+        Case(const char *description,
+             const case_benchmark_handler_t case_handler,
+             const case_failure_handler_t failure_handler = default_handler);
+
+        Case(const char *description,
+             const case_benchmark_handler_t case_handler,
+             const case_teardown_handler_t teardown_handler,
+             const case_failure_handler_t failure_handler = default_handler);
+
+        // overloads for paired case_benchmark_handler_t, comparing the candidate with the baseline handler
+        Case(const char *description,
+             const case_setup_handler_t setup_handler,
+             const case_benchmark_handler_t baseline_handler,
+             const case_benchmark_handler_t candidate_handler,
+             const case_teardown_handler_t teardown_handler = default_handler,
+             const case_failure_handler_t failure_handler = default_handler);
+
+        Case(const char *description,
+             const case_benchmark_handler_t baseline_handler,
+             const case_benchmark_handler_t candidate_handler,
+             const case_failure_handler_t failure_handler = default_handler);
+
+        Case(const char *description,
+             const case_benchmark_handler_t baseline_handler,
+             const case_benchmark_handler_t candidate_handler,
+             const case_teardown_handler_t teardown_handler,
+             const case_failure_handler_t failure_handler = default_handler);
+
 
         /// @returns the textual description of the test case
         const char* get_description() const;
@@ -108,19 +143,48 @@ namespace v1 {
         /// @returns `true` if setup, test and teardown handlers are set to `ignore_handler`
         bool is_empty() const;
 
+        /// Adds attributes to this test case.
+        /// @returns a reference to this test case, so attributes can be added in the case declaration.
+        Case &with_attributes(const case_attribute_t attributes);
+
+        /// @returns the attributes of this test case
+        case_attribute_t get_attributes() const;
+
+        /// Limits the stack this test case may use, when the harness monitors its stack.
+        /// Zero, the default, does not limit the stack.
+        /// @returns a reference to this test case, so the budget can be set in the case declaration.
+        Case &with_stack_budget(const size_t bytes);
+
+        /// @returns the stack budget of this test case in bytes, or zero if its stack is not limited
+        size_t get_stack_budget() const;
+
+        /// Interrupts the case handler, if it does not return within `timeout_ms`, overriding the watchdog of the harness.
+        /// @returns a reference to this test case, so the watchdog can be set in the case declaration.
+        Case &with_watchdog(const uint32_t timeout_ms);
+
+        /// @returns the watchdog timeout of this test case in milliseconds, or zero to use the one of the harness
+        uint32_t get_watchdog() const;
+
     private:
         const char *description;
 
         const case_handler_t handler;
         const case_control_handler_t control_handler;
         const case_call_count_handler_t repeat_count_handler;
+        const case_benchmark_handler_t benchmark_handler;
+        const case_benchmark_handler_t comparison_handler;
 
         const case_setup_handler_t setup_handler;
         const case_teardown_handler_t teardown_handler;
 
         const case_failure_handler_t failure_handler;
 
+        case_attribute_t attributes;
+        size_t stack_budget;
+        uint32_t watchdog_ms;
+
         friend class Harness;
+        friend class HarnessContext;
     };
 
 }   // namespace v1
@@ -0,0 +1,123 @@
+/****************************************************************************
+ * Copyright (c) 2016, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ****************************************************************************
+ */
+
+#ifndef UTEST_CRASH_GUARD_H
+#define UTEST_CRASH_GUARD_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifndef UTEST_CRASH_GUARD_AVAILABLE
+#   if defined(__GNUC__) && (defined(__unix__) || defined(__APPLE__))
+#       define UTEST_CRASH_GUARD_AVAILABLE 1
+#   else
+#       define UTEST_CRASH_GUARD_AVAILABLE 0
+#   endif
+#endif
+
+#ifndef UTEST_WATCHDOG_AVAILABLE
+#   if UTEST_CRASH_GUARD_AVAILABLE && defined(__linux__)
+#       define UTEST_WATCHDOG_AVAILABLE 1
+#   else
+#       define UTEST_WATCHDOG_AVAILABLE 0
+#   endif
+#endif
+
+#ifndef UTEST_CRASH_BACKTRACE_DEPTH
+#   ifdef YOTTA_CFG_UTEST_CRASH_BACKTRACE_DEPTH
+#       define UTEST_CRASH_BACKTRACE_DEPTH YOTTA_CFG_UTEST_CRASH_BACKTRACE_DEPTH
+#   else
+#       define UTEST_CRASH_BACKTRACE_DEPTH 32
+#   endif
+#endif
+
+namespace utest {
+namespace v1 {
+
+    /** Recovers from crashing signals of a function.
+     *
+     * While installed, `SIGSEGV`, `SIGBUS`, `SIGILL`, `SIGFPE` and `SIGABRT` raised inside `call()` jump back
+     * into `call()` with `siglongjmp()`, which then returns `false`.
+     * The signals are handled on an alternate signal stack of the installing thread, so that a stack overflow
+     * can be recovered from as well.
+     * Outside of `call()` and on other threads the signals take their previous action.
+     *
+     * A call with a timeout is interrupted the same way by a watchdog, which is a timer signalling the calling
+     * thread with `UTEST_WATCHDOG_SIGNAL` (default `SIGRTMIN`), even if the crash signals are not installed.
+     * A nested call with a timeout takes over the watchdog until it returns, then the enclosing call continues
+     * with its remaining time.
+     *
+     * Recovering is best effort: destructors of the abandoned frames are not executed, and locks held
+     * by them, ie. inside the allocator, are never released.
+     *
+     * On glibc hosts the backtrace of the crash is recorded in the signal handler.
+     *
+     * @note The guard is only available on POSIX hosts (`UTEST_CRASH_GUARD_AVAILABLE`),
+     *       the watchdog only on Linux hosts (`UTEST_WATCHDOG_AVAILABLE`).
+     */
+    class CrashGuard
+    {
+    public:
+        CrashGuard();
+        /// Restores the previous signal actions.
+        ~CrashGuard();
+
+        /// Installs the signal handlers and the alternate signal stack of the calling thread.
+        /// @returns `false` if the guard is not available or could not be installed
+        bool install();
+
+        /// Restores the previous signal actions.
+        void uninstall();
+
+        /// Executes `function(context)`, which the watchdog interrupts after `timeout_ms`, unless it is zero.
+        /// @returns `false` if the function crashed or has been interrupted
+        bool call(void (*function)(void*), void *context, const uint32_t timeout_ms = 0);
+
+        /// @returns the signal of the last crash, or zero
+        int get_signal() const { return signal; }
+
+        /// @returns `true` if the watchdog interrupted the last call that did not return
+        bool has_timed_out() const { return timed_out_ms != 0; }
+
+        /// Prints the signal, faulting address and backtrace of the last crash.
+        void print() const;
+
+    private:
+        CrashGuard(const CrashGuard&);
+        CrashGuard &operator=(const CrashGuard&);
+
+        struct watchdog_t;
+        bool arm_watchdog(const uint32_t timeout_ms, uint64_t &previous_ns);
+        void disarm_watchdog(const uint64_t previous_ns);
+        void release_watchdog();
+
+        int signal;
+        uint32_t timed_out_ms;                      ///< the timeout of the last call, if the watchdog interrupted it
+        void *address;                              ///< the faulting address of the last crash
+        void *frames[UTEST_CRASH_BACKTRACE_DEPTH];  ///< the backtrace of the last crash
+        int frame_count;
+        void *signal_stack;
+        watchdog_t *watchdog;                       ///< created by the first call with a timeout
+        bool is_installed;
+    };
+
+}   // namespace v1
+}   // namespace utest
+
+#endif // UTEST_CRASH_GUARD_H
@@ -56,6 +56,7 @@ namespace v1 {
         operator case_handler_t()            const { return case_handler_t(NULL); }
         operator case_control_handler_t()    const { return case_control_handler_t(NULL); }
         operator case_call_count_handler_t() const { return case_call_count_handler_t(NULL); }
+        operator case_benchmark_handler_t()  const { return case_benchmark_handler_t(NULL); }
 
         operator test_setup_handler_t()    const { return test_setup_handler_t(NULL); }
         operator test_teardown_handler_t() const { return test_teardown_handler_t(NULL); }
@@ -64,6 +65,10 @@ namespace v1 {
         operator case_setup_handler_t()    const { return case_setup_handler_t(NULL); }
         operator case_teardown_handler_t() const { return case_teardown_handler_t(NULL); }
         operator case_failure_handler_t()  const { return case_failure_handler_t(NULL); }
+
+        operator case_benchmark_report_handler_t() const { return case_benchmark_report_handler_t(NULL); }
+        operator case_comparison_report_handler_t() const { return case_comparison_report_handler_t(NULL); }
+        operator case_metrics_report_handler_t() const { return case_metrics_report_handler_t(NULL); }
     } ignore_handler;
 
     /** A table of handlers.
@@ -98,6 +103,10 @@ namespace v1 {
         case_teardown_handler_t case_teardown;
         case_failure_handler_t case_failure;
 
+        case_benchmark_report_handler_t case_benchmark;
+        case_comparison_report_handler_t case_comparison;
+        case_metrics_report_handler_t case_metrics;
+
         inline test_setup_handler_t get_handler(test_setup_handler_t handler) const {
             if (handler == default_handler) return test_setup;
             return handler;
@@ -138,6 +147,12 @@ namespace v1 {
     status_t verbose_case_teardown_handler(const Case *const source, const size_t passed, const size_t failed, const failure_t failure);
     /// Prints the reason of the failure and continues, unless the teardown handler failed, for which it aborts.
     status_t verbose_case_failure_handler (const Case *const source, const failure_t reason);
+    /// Prints the statistics of the benchmark test case.
+    void     verbose_case_benchmark_handler(const Case *const source, const benchmark_result_t result);
+    /// Prints the ratio of the paired benchmark test case.
+    void     verbose_case_comparison_handler(const Case *const source, const benchmark_comparison_t comparison);
+    /// Prints the time spent in each phase of the test case.
+    void     verbose_case_metrics_handler(const Case *const source, const case_metrics_t &metrics);
 
     /// Requests the start test case from greentea and continues.
     status_t greentea_test_setup_handler   (const size_t number_of_cases);
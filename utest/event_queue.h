@@ -0,0 +1,95 @@
+/****************************************************************************
+ * Copyright (c) 2016, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ****************************************************************************
+ */
+
+#ifndef UTEST_EVENT_QUEUE_H
+#define UTEST_EVENT_QUEUE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "types.h"
+
+#ifndef UTEST_EVENT_QUEUE_SIZE
+#   ifdef YOTTA_CFG_UTEST_EVENT_QUEUE_SIZE
+#       define UTEST_EVENT_QUEUE_SIZE YOTTA_CFG_UTEST_EVENT_QUEUE_SIZE
+#   else
+#       define UTEST_EVENT_QUEUE_SIZE 32
+#   endif
+#endif
+
+namespace utest {
+namespace v1 {
+
+    class Case;
+
+    /** Queue of the validations and failures that arrive outside of the thread executing a harness context.
+     *
+     * This is a bounded multi-producer single-consumer ring over a fixed number of statically allocated slots,
+     * so it never allocates memory or takes a lock and can be pushed to from any thread or interrupt handler.
+     * Every slot carries a sequence number, which tells producers whether the slot is free and the consumer
+     * whether the event in it has been published.
+     *
+     * Only the thread executing the harness context may pop events.
+     * `UTEST_EVENT_QUEUE_SIZE` must be a power of two.
+     */
+    class EventQueue
+    {
+    public:
+        enum event_type_t {
+            EVENT_VALIDATION,   ///< `validate_callback(source, control)`
+            EVENT_FAILURE       ///< `raise_failure(source, reason)`
+        };
+
+        struct event_t
+        {
+            event_type_t type;
+            const Case *source;         ///< `NULL` for the test case executing when the event is handled
+            control_t control;
+            failure_reason_t reason;
+            uint64_t time_ns;           ///< the time the event was pushed
+        };
+
+        EventQueue();
+
+        /// Removes all events, must only be called by the consumer.
+        void clear();
+
+        /// Copies `event` into the queue, may be called from any thread or interrupt.
+        /// @returns `false` if the queue is full
+        bool push(const event_t &event);
+
+        /// Removes the oldest published event, must only be called by the consumer.
+        /// @returns `true` if an event was copied into `event`, `false` if the queue is empty
+        bool pop(event_t &event);
+
+    private:
+        struct slot_t
+        {
+            volatile size_t sequence;
+            event_t event;
+        };
+
+        slot_t slots[UTEST_EVENT_QUEUE_SIZE];
+        volatile size_t enqueue_position;
+        size_t dequeue_position;
+    };
+
+}   // namespace v1
+}   // namespace utest
+
+#endif // UTEST_EVENT_QUEUE_H
@@ -0,0 +1,86 @@
+/****************************************************************************
+ * Copyright (c) 2016, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ****************************************************************************
+ */
+
+#ifndef UTEST_FORK_SERVER_H
+#define UTEST_FORK_SERVER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifndef UTEST_FORK_SERVER_AVAILABLE
+#   if defined(__GNUC__) && (defined(__unix__) || defined(__APPLE__))
+#       define UTEST_FORK_SERVER_AVAILABLE 1
+#   else
+#       define UTEST_FORK_SERVER_AVAILABLE 0
+#   endif
+#endif
+
+namespace utest {
+namespace v1 {
+
+    /** Server forking a copy of the calling process for every request on a local socket.
+     *
+     * A request is a single line `<first> <count>\n` selecting a range of test cases, where a `count` of zero
+     * selects all following test cases.
+     * The output of the forked process is sent back over the connection, which is closed when the process exits.
+     *
+     * @note The server is only available on POSIX hosts (`UTEST_FORK_SERVER_AVAILABLE`).
+     */
+    class ForkServer
+    {
+    public:
+        ForkServer();
+        /// Closes and removes the socket, if this is the serving process.
+        ~ForkServer();
+
+        /** Listens on the local socket `path` and forks for each request.
+         *
+         * This function returns in the forked process, with its standard output and error redirected
+         * to the connection, if the socket could not be created, or once `SIGTERM` or `SIGINT` stops the server.
+         * A stopped server removes its socket.
+         *
+         * @retval `true`  in a forked process, with the requested range of test cases
+         * @retval `false` if the socket could not be created or the server was stopped
+         */
+        bool serve(const char *path, size_t &first, size_t &count);
+
+        /// @returns `true` if `serve()` returned because `SIGTERM` or `SIGINT` stopped the server
+        bool was_stopped() const { return stopped; }
+
+        /** Sends a request to the server listening on `path` and receives the output.
+         *
+         * @param buffer    receives the null-terminated output, truncated to `size`
+         * @returns the length of the output, or `-1` if the server could not be reached
+         */
+        static int request(const char *path, const size_t first, const size_t count, char *buffer, const size_t size);
+
+    private:
+        ForkServer(const ForkServer&);
+        ForkServer &operator=(const ForkServer&);
+
+        int socket_fd;
+        int server_pid;     ///< only the serving process removes the socket
+        const char *path;
+        bool stopped;
+    };
+
+}   // namespace v1
+}   // namespace utest
+
+#endif // UTEST_FORK_SERVER_H
@@ -28,11 +28,307 @@
 #include "default_handlers.h"
 #include "specification.h"
 #include "scheduler.h"
+#include "event_queue.h"
 
+#ifndef UTEST_TIMEOUT_HEADROOM_PERCENT
+#   ifdef YOTTA_CFG_UTEST_TIMEOUT_HEADROOM_PERCENT
+#       define UTEST_TIMEOUT_HEADROOM_PERCENT YOTTA_CFG_UTEST_TIMEOUT_HEADROOM_PERCENT
+#   else
+#       define UTEST_TIMEOUT_HEADROOM_PERCENT 10
+#   endif
+#endif
+
+#ifndef UTEST_STACK_MONITOR_SIZE
+#   ifdef YOTTA_CFG_UTEST_STACK_MONITOR_SIZE
+#       define UTEST_STACK_MONITOR_SIZE YOTTA_CFG_UTEST_STACK_MONITOR_SIZE
+#   else
+#       define UTEST_STACK_MONITOR_SIZE (1024 * 1024)
+#   endif
+#endif
+
+#ifndef UTEST_ISOLATION_TIMEOUT_MS
+#   ifdef YOTTA_CFG_UTEST_ISOLATION_TIMEOUT_MS
+#       define UTEST_ISOLATION_TIMEOUT_MS YOTTA_CFG_UTEST_ISOLATION_TIMEOUT_MS
+#   else
+#       define UTEST_ISOLATION_TIMEOUT_MS 10000
+#   endif
+#endif
 
 namespace utest {
 namespace v1 {
 
+    class WorkerPool;
+    class ProcessPool;
+    class BenchmarkBaseline;
+    class BenchmarkComparison;
+    class PerfCounters;
+    class StackMonitor;
+    class Arena;
+    class CrashGuard;
+
+    /** Test Harness Context.
+     *
+     * This class holds the complete run state of one test specification.
+     * Several contexts can be instantiated, which allows running independent specifications
+     * concurrently on different threads or event loops in the same process.
+     * Each context needs its own scheduler instance for this, since the harness callbacks
+     * of a context must be executed on the thread or event loop that runs this context.
+     *
+     * While a context executes its callbacks, it is the current context of the executing thread,
+     * so the static `Harness` functions (and therefore the unity assertion macros) act on it.
+     *
+     * The default context is used by the `Harness` class and calls `exit()` once its specification
+     * has finished, as it always did. All other contexts stop when their specification has finished
+     * or was aborted and can be started again afterwards.
+     */
+    class HarnessContext
+    {
+    public:
+        /// Creates a context that does not call `exit()` when its specification finished.
+        HarnessContext();
+        ~HarnessContext();
+
+        /// Runs a test specification using the scheduler of this context.
+        /// This starts the specification and then calls the `run()` function of the scheduler.
+        /// @retval `true`  if the specification can be run
+        /// @retval `false` if another specification is currently running in this context
+        bool run(const Specification& specification);
+
+        /// Starts a test specification by posting the first harness callback to the scheduler.
+        /// Use this if you run the event loop of the scheduler yourself.
+        /// @retval `true`  if the specification has been started
+        /// @retval `false` if another specification is currently running in this context
+        bool start(const Specification& specification);
+
+        /// @see Harness::serve
+        bool serve(const Specification& specification, const char *path);
+
+        /// @returns `true` if a test specification is being executed, `false` otherwise
+        bool is_busy() const;
+
+        /// Sets the scheduler to be used by this context.
+        /// The scheduler is wrapped into the version 2 interface using `utest_v1_scheduler_adapt()`.
+        /// @return `true` if scheduler is properly specified (all functions non-null).
+        bool set_scheduler(const utest_v1_scheduler_t scheduler);
+
+        /// Sets the scheduler to be used by this context.
+        /// @return `true` if scheduler is properly specified (version 2 and all required functions non-null).
+        bool set_scheduler(const utest_v1_scheduler_v2_t scheduler);
+
+        /// @see Harness::set_workers
+        bool set_workers(const size_t count);
+
+        /// @see Harness::set_isolation
+        bool set_isolation(const size_t processes, const uint32_t timeout_ms = UTEST_ISOLATION_TIMEOUT_MS);
+
+        /// @see Harness::set_baseline
+        bool set_baseline(const char *load_path, const char *save_path = NULL);
+
+        /// @see Harness::set_perf_counters
+        bool set_perf_counters(const bool enable);
+
+        /// @see Harness::set_stack_monitor
+        bool set_stack_monitor(const size_t size = UTEST_STACK_MONITOR_SIZE);
+        /// @see Harness::set_stack_monitor
+        bool set_stack_monitor(void *base, const size_t size);
+
+        /// @see Harness::set_arena
+        bool set_arena(const size_t size, const bool huge_pages = false);
+
+        /// @see Harness::allocate
+        void *allocate(const size_t size);
+
+        /// @see Harness::set_crash_guard
+        bool set_crash_guard(const bool enable);
+
+        /// @see Harness::set_watchdog
+        bool set_watchdog(const uint32_t timeout_ms);
+
+        /// @see Harness::set_pipelining
+        bool set_pipelining(const size_t depth);
+
+        /// @see Harness::validate_callback
+        void validate_callback(const control_t control = control_t());
+        /// @see Harness::validate_callback
+        void validate_callback(const Case *const source, const control_t control = control_t());
+
+        /// @see Harness::raise_failure
+        void raise_failure(const failure_reason_t reason);
+        /// @see Harness::raise_failure
+        void raise_failure(const Case *const source, const failure_reason_t reason);
+
+        /// @see Harness::get_current_case
+        const Case *get_current_case() const;
+
+        /// @returns the number of passed test cases of the current or last specification
+        size_t get_passed() const { return test_passed; }
+        /// @returns the number of failed test cases of the current or last specification
+        size_t get_failed() const { return test_failed; }
+        /// @returns the failure of the last specification, as passed to its test teardown handler
+        failure_t get_failure() const { return test_failure; }
+        /// @see Harness::get_case_metrics
+        const case_metrics_t &get_case_metrics() const { return case_metrics; }
+
+        /// @returns the context executing on the calling thread, or the default context
+        static HarnessContext &get_current();
+        /// @returns the context used by the `Harness` class
+        static HarnessContext &get_default();
+
+    protected:
+        static void run_next_case(void *context);
+        static void handle_timeout(void *context);
+        static void schedule_next_case(void *context);
+        static void resume_steps(void *context);
+        static void call_case_handler(void *context);
+        static void drain_events(void *context);
+
+        void run_next_case();
+        void handle_timeout();
+        void schedule_next_case();
+        void call_case_handler();
+        bool call_handler(void (*function)(void*), void *context, const Case &source, case_metrics_t &metrics);
+        void raise_handler_failures(const Case &source, const bool crashed, case_metrics_t &metrics);
+        void call_test_failure(const failure_t failure);
+        void drain_events();
+        void handle_events();
+        typedef void (HarnessContext::*step_t)();
+        void run_steps(step_t step);
+        void post_step(const step_t step, const utest_v1_harness_callback_v2_t callback);
+
+        bool setup(const Specification& specification);
+        void run_scheduler();
+        void finish(const failure_t failure, const int status);
+        void next_case();
+        bool is_executing() const;
+        void post_event(const EventQueue::event_type_t type, const Case *const source, const control_t control, const failure_reason_t reason);
+        void count_validation(const control_t control, const uint64_t time_ns);
+        void validate_source(const Case *const source, const control_t control, const uint64_t time_ns);
+        void raise_source_failure(const Case *const source, const failure_reason_t reason);
+        bool change_case_state(const uint32_t from, const uint32_t to);
+        void complete_wait();
+        static void record_latency(case_metrics_t &metrics, bool &headroom_exceeded, const uint32_t timeout, const uint64_t latency_ns);
+        void report_case_metrics();
+        void reset_case_metrics();
+        void measure_case_usage();
+
+        size_t calibrate_benchmark(const case_benchmark_handler_t handler);
+        void run_benchmark();
+        control_t run_comparison();
+
+        bool run_isolated_case();
+        void report_isolated_case();
+
+        static bool is_parallel(const Case &test_case);
+        bool join_parallel_case();
+        void release_parallel_cases();
+        static void run_parallel_case(void *context, const size_t index);
+
+        static bool is_pipelined(const Case &test_case);
+        void dispatch_pipelined_cases();
+        static void call_pipelined_handler(void *context);
+        bool join_pipelined_case();
+        bool adopt_pipelined_wait();
+        void release_pipelined_cases();
+        static void handle_pipelined_timeout(void *context);
+
+    private:
+        HarnessContext(const bool exit_on_finish);
+        HarnessContext(const HarnessContext&);
+        HarnessContext &operator=(const HarnessContext&);
+        /// initializes the members shared by both constructors
+        void init();
+
+        /// makes this context the current context of the calling thread for its lifetime
+        class Scope;
+        /// the failures of a test case executed by a worker
+        struct parallel_case_t;
+        /// the wait of a test case, whose handler has been dispatched ahead of it
+        struct pipelined_case_t;
+        /// the states of the wait for the callbacks of the current test case
+        enum case_state_t {
+            CASE_STATE_IDLE,        ///< no callbacks are awaited, ie. the handlers of the test case are executing
+            CASE_STATE_STARTING,    ///< the case handler returned and the harness starts the wait
+            CASE_STATE_AWAITING,    ///< the callbacks are awaited
+            CASE_STATE_VALIDATED,   ///< a callback completed the wait, which the harness still has to handle
+            CASE_STATE_COMPLETED    ///< the wait has been completed, timed out or aborted
+        };
+        pipelined_case_t *find_pipelined_case(const Case *const source);
+
+        const Case *test_cases;
+        size_t test_length;
+
+        size_t test_index_of_case;
+
+        size_t test_passed;
+        size_t test_failed;
+        failure_t test_failure;
+
+        const Case *case_current;
+        size_t case_index;
+        control_t case_control;
+        size_t case_repeat_count;
+
+        utest_v1_scheduler_handle_t case_timeout_handle;
+        volatile size_t case_validation_count;  ///< counted without a lock, see `validate_callback()`
+        volatile uint32_t case_state;           ///< the `case_state_t` of the wait, changed atomically
+        control_t case_validated_control;       ///< passed to the validation completing the wait
+        uint64_t case_validated_ns;             ///< the time of the validation completing the wait
+        bool case_timeout_occurred;
+        bool case_headroom_exceeded;    ///< a callback was validated with less than `UTEST_TIMEOUT_HEADROOM_PERCENT` of its timeout left
+
+        size_t case_passed;
+        size_t case_failed;
+        size_t case_failed_before;
+
+        case_metrics_t case_metrics;
+        uint64_t case_wait_start;   ///< the time the case handler returned to await its callback
+        int64_t case_live_bytes;    ///< the allocated bytes before the test case started
+        int64_t case_live_blocks;   ///< the allocated blocks before the test case started
+        uint64_t case_handler_allocations;  ///< the allocations of the last case handler call on this thread
+
+        handlers_t defaults;
+        handlers_t handlers;
+
+        location_t location;
+
+        utest_v1_scheduler_v2_t scheduler;
+        bool is_running_steps;
+        step_t next_step;   ///< executed by `run_steps()` instead of posting it to the scheduler
+        utest_v1_scheduler_handle_t step_handle;    ///< the step posted to the scheduler, canceled on destruction
+
+        WorkerPool *workers;
+        const Case *parallel_begin;
+        size_t parallel_length;
+        parallel_case_t *parallel_cases;
+
+        size_t pipeline_depth;              ///< the maximum number of test cases awaiting their callback at once
+        const Case *pipelined_begin;
+        size_t pipelined_length;
+        pipelined_case_t *pipelined_cases;
+        pipelined_case_t *pipelined_dispatch;   ///< the test case, whose handler is being dispatched
+        pipelined_case_t *case_pipelined;       ///< the joined test case, whose wait is adopted once its handler returned
+
+        ProcessPool *processes;
+        size_t isolation_processes;
+        uint32_t isolation_timeout_ms;
+
+        BenchmarkBaseline *baseline;
+        BenchmarkComparison *comparison;
+
+        PerfCounters *perf_counters;    ///< counts the case handler, if enabled
+        StackMonitor *stack_monitor;    ///< measures the stack of every test case, if enabled
+        Arena *arena;                   ///< the allocations of the current test case, if enabled
+        CrashGuard *crash_guard;        ///< recovers from crashes of the case handler and executes the watchdog, if enabled
+        uint32_t watchdog_timeout_ms;   ///< the watchdog of every case handler and test failure handler, if not zero
+
+        EventQueue *events;             ///< the validations and failures arriving from other threads or interrupts
+        volatile bool events_pending;   ///< `drain_events()` has been posted to the scheduler
+        utest_v1_scheduler_handle_t drain_handle;
+        volatile size_t events_lost;    ///< the events dropped, because the queue was full
+
+        bool exit_on_finish;
+    };
+
     /** Test Harness.
      *
      * This class runs a test specification for you and calls all required handlers.
@@ -44,6 +340,9 @@ namespace v1 {
      * inside your yotta config and set a custom scheduler implementation using the `set_scheduler()` function.
      * You must set the scheduler before running a specification.
      *
+     * The `run()` and `set_scheduler()` functions act on the default `HarnessContext`, all other functions
+     * act on the context currently executing on the calling thread.
+     *
      * @note In case of an test abort, the harness will busy-wait and never finish.
      */
     class Harness
@@ -54,6 +353,26 @@ namespace v1 {
         /// @retval `false` if another specification is currently running
         static bool run(const Specification& specification);
 
+        /** Runs the test setup handler once and then serves requests for test cases on a local socket.
+         *
+         * For every request, the process forks a copy of itself, which starts directly at the first requested
+         * test case and sends its output back over the connection.
+         * Expensive fixtures loaded by the test setup handler are therefore shared copy-on-write by all
+         * requests, instead of being loaded again for every run of the binary.
+         *
+         * A request is a single line `<first> <count>\n`, where a `count` of zero requests all test cases
+         * from index `first` onwards, for example `echo "3 1" | socat - UNIX-CONNECT:<path>`.
+         * The connection is closed once the forked process exits.
+         *
+         * @note The fork server is only available on POSIX hosts.
+         *
+         * The forked processes exit once their test cases have finished, so this function only returns
+         * if the test setup handler failed, if the socket could not be created, or once `SIGTERM` or `SIGINT`
+         * stopped the server, which then removes its socket.
+         * @retval `false` if another specification is currently running or the socket could not be created
+         */
+        static bool serve(const Specification& specification, const char *path);
+
         /// @cond
         __deprecated_message("Start case selection is done by returning the index from the test setup handler!")
         static bool run(const Specification& specification, size_t start_case);
@@ -63,15 +382,192 @@ namespace v1 {
         static bool is_busy();
 
         /// Sets the scheduler to be used.
+        /// The scheduler is wrapped into the version 2 interface using `utest_v1_scheduler_adapt()`.
         /// @return `true` if scheduler is properly specified (all functions non-null).
         static bool set_scheduler(utest_v1_scheduler_t scheduler);
 
+        /// Sets the scheduler to be used.
+        /// @return `true` if scheduler is properly specified (version 2 and all required functions non-null).
+        static bool set_scheduler(utest_v1_scheduler_v2_t scheduler);
+
+        /** Sets the number of worker threads executing independent test cases in parallel.
+         *
+         * Consecutive test cases with the `CASE_ATTRIBUTE_INDEPENDENT` attribute and a `void(void)` handler
+         * are executed on these workers, while their setup, teardown and failure handlers are still called
+         * in declaration order on the thread running the harness.
+         * Set the count to zero to execute all test cases serially, which is the default unless
+         * `config.utest.worker_pool_size` is set.
+         *
+         * @note Worker threads are only available on POSIX hosts.
+         * @return `true` if all workers have been started.
+         */
+        static bool set_workers(const size_t count);
+
+        /** Overlaps the waits of up to `depth` consecutive asynchronous test cases.
+         *
+         * When the harness reaches a test case with the `CASE_ATTRIBUTE_OVERLAPPABLE` attribute and a `control_t(void)`
+         * handler, it calls the handlers of this and the directly following overlappable test cases right away.
+         * Each of these test cases awaits its own callback with its own timeout, so the waits overlap.
+         * The harness then joins the test cases in declaration order and reports them through the usual
+         * case setup, teardown and failure handlers, as if they had been executed one after the other.
+         *
+         * The callback of an overlapped test case must validate it with `validate_callback(source)`, where `source`
+         * is the test case returned by `get_current_case()` inside its handler, and report failures with
+         * `raise_failure(source, reason)`, since the harness may still wait for an earlier test case.
+         * The handlers may execute before their case setup handler is called, as with parallel test cases.
+         *
+         * A depth of zero or one executes all test cases one after the other, which is the default.
+         * @return `false` if a specification is currently running
+         */
+        static bool set_pipelining(const size_t depth);
+
+        /** Executes every test case in its own process.
+         *
+         * The test cases are executed in copies of the process, which are forked in advance and wait
+         * for their test case, so that a test case costs only a `fork()`.
+         * A test case crashing, hanging for longer than `timeout_ms` or aborting the specification only fails
+         * this test case, the harness reports it through the failure and teardown handlers and continues
+         * with the next test case.
+         *
+         * @note Process isolation is only available on POSIX hosts and takes precedence over parallel execution.
+         *
+         * @param processes     the number of forked processes waiting for a test case, zero disables process isolation
+         * @param timeout_ms    the time after which a test case is considered hanging, zero disables the timeout
+         * @return `true` if process isolation is available
+         */
+        static bool set_isolation(const size_t processes, const uint32_t timeout_ms = UTEST_ISOLATION_TIMEOUT_MS);
+
+        /** Compares benchmark test cases with a baseline and records their samples.
+         *
+         * After a benchmark test case has been measured, its samples are compared with the samples of
+         * the test case with the same description in the baseline file `load_path`.
+         * If the test case is significantly slower, `REASON_PERF_REGRESSION` is raised as a failure of this test case.
+         * The samples of all benchmark test cases are written to the file `save_path`, which can be used as the next baseline.
+         *
+         * Either path may be `NULL`, set both to `NULL` to disable the comparison.
+         * @return `false` if a file could not be opened
+         */
+        static bool set_baseline(const char *load_path, const char *save_path = NULL);
+
+        /** Counts instructions, cycles, cache misses, branch misses and context switches of every case handler.
+         *
+         * The counts of each test case are part of its metrics, see `get_case_metrics()`.
+         * Only the thread running the harness is counted, so the handlers of independent test cases executing
+         * on worker threads are not.
+         *
+         * The counters are opened for the calling thread, which must be the thread running the harness.
+         *
+         * @note Performance counters are only available on Linux hosts, where `perf_event_paranoid` may restrict them.
+         * @return `true` if at least one counter could be opened, or if the counters have been disabled
+         */
+        static bool set_perf_counters(const bool enable);
+
+        /** Measures the peak stack usage of every test case.
+         *
+         * On glibc Linux hosts an alternate stack of `size` bytes is allocated, with an inaccessible guard page
+         * below it, and the harness executes all handlers of a test case on it.
+         * The stack is painted before each test case and its high-water mark after the last teardown is part of
+         * the metrics in `stack_peak_bytes`, including the frames of the harness and the scheduler callback.
+         * A test case with a stack budget (see `Case::with_stack_budget()`) raises `REASON_STACK_BUDGET`
+         * whenever its setup and case handler used more stack than the budget.
+         *
+         * Only the thread running the harness is monitored, so the handlers of independent test cases executing
+         * on worker threads are not.
+         * Callbacks executed by the scheduler directly, like `validate_callback()` and timeouts, do not execute
+         * on the alternate stack.
+         *
+         * A size of zero disables the monitor.
+         * @return `false` if alternate stacks are not available or the stack could not be allocated
+         */
+        static bool set_stack_monitor(const size_t size = UTEST_STACK_MONITOR_SIZE);
+
+        /** Measures the peak stack usage of every test case on the existing stack running the harness.
+         *
+         * This is meant for targets, whose main stack is known from the linker, ie. between `__StackLimit`
+         * and `__StackTop`.
+         * The part of the stack below the harness is painted before each test case, so make sure
+         * `size` bytes starting at `base` are actually accessible.
+         * A `base` of `NULL` disables the monitor.
+         */
+        static bool set_stack_monitor(void *base, const size_t size);
+
+        /** Provides an arena of `size` bytes for the allocations of every test case.
+         *
+         * Allocating from the arena with `allocate()` only advances an offset, and instead of freeing
+         * each allocation, the harness releases the complete arena after the last teardown of every test case.
+         * So test cases allocating many short-lived objects neither pay for nor fragment the heap, and
+         * whatever a test case did not clean up does not leak into the next one.
+         *
+         * On Linux hosts the arena can be backed by huge pages, which reduces TLB misses of large arenas.
+         *
+         * A size of zero disables the arena.
+         * @return `false` if the arena could not be allocated
+         */
+        static bool set_arena(const size_t size, const bool huge_pages = false);
+
+        /** Allocates `size` bytes from the arena of the current test case, aligned for any type.
+         *
+         * The memory is valid until the last teardown of the current test case has finished.
+         * Objects constructed in it with placement `new` are never destructed.
+         *
+         * @note Independent test cases executing on worker threads and the handlers of overlapped test cases,
+         *       which are called ahead of their test case, cannot allocate from the arena.
+         * @return `NULL` if the arena is disabled or has not enough space left
+         */
+        static void *allocate(const size_t size);
+
+        /** Turns crashes of case handlers into failures of their test case.
+         *
+         * While a case handler executes, `SIGSEGV`, `SIGBUS`, `SIGILL`, `SIGFPE` and `SIGABRT` jump back into the
+         * harness, which prints the signal and, on glibc hosts, the backtrace of the crash.
+         * It then raises `REASON_CRASH` and continues with the case teardown and the next test case,
+         * instead of losing the results of all remaining test cases.
+         *
+         * Recovering is best effort: destructors of the abandoned frames are not executed and locks held by them are
+         * never released, so a crash inside the allocator may still hang the specification.
+         * Use `set_isolation()` where that is a concern.
+         * Only the thread running the harness is guarded, so crashes of independent test cases executing on worker
+         * threads still terminate the process.
+         *
+         * The signal handlers are installed for the calling thread, which must be the thread running the harness.
+         *
+         * @note The crash guard is only available on POSIX hosts.
+         * @return `true` if the guard has been installed, or if it has been disabled
+         */
+        static bool set_crash_guard(const bool enable);
+
+        /** Interrupts case handlers that do not return within `timeout_ms`.
+         *
+         * Timeouts declared with `control_t` only start once the case handler returned, so a synchronous case handler
+         * stuck in an endless loop hangs the specification forever.
+         * The watchdog interrupts such a case handler from a timer signal, raises `REASON_TIMEOUT` at
+         * `LOCATION_CASE_HANDLER` and continues with the case teardown and the next test case.
+         * A test case may set its own watchdog with `Case::with_watchdog()`, which overrides this one.
+         *
+         * The test failure handler is executed under this watchdog as well, since the default handlers halt after
+         * a failure of the test setup or teardown, so that the specification finishes instead.
+         *
+         * Every call of the case handler is interrupted separately, including the measurement of a benchmark.
+         * Interrupting a case handler has the same limitations as recovering from a crash, see `set_crash_guard()`.
+         * A timeout of zero disables the watchdog.
+         *
+         * @note The watchdog is only available on Linux hosts.
+         * @return `false` if the watchdog is not available
+         */
+        static bool set_watchdog(const uint32_t timeout_ms);
+
         /** Call this function in the asynchronous callback that you have been waiting for.
          *
          * You can only validate a callback once, calling this function when no callback is expected
          * has no side effects.
          * After callback validation, the next test case is scheduled.
          *
+         * A test case awaiting several callbacks with `CaseAwaitCount(count, ms)` is validated by the `count`-th call.
+         * The calls are counted without a lock, so the callbacks may arrive concurrently on several threads or
+         * in interrupts, and the latency of every call is part of the metrics of the test case.
+         * A validation completing the wait outside of the thread executing the context is handled once that thread
+         * drains its events.
+         *
          * You may specify additional test case attributes with this callback.
          * So for example, you may delay the decision to repeat an asynchronous test case until the callback
          * needs to be validated.
@@ -79,18 +575,37 @@ namespace v1 {
          * However, be aware, that only the repeat attributes can be modified and the usual arbitration rules apply.
          * The modified case attributes are only valid until the case handler returns updated attributes.
          *
+         * @note If the callback arrives on a thread that does not execute a context, the default context is validated.
+         *       Use `HarnessContext::validate_callback()` directly in this case.
+         *
          * @param control   the test case attribute to be added to the existing attributes.
          */
         static void validate_callback(const control_t control = control_t());
 
+        /// Validates the callback of the test case `source`, which may still overlap with earlier test cases.
+        /// @see set_pipelining
+        static void validate_callback(const Case *const source, const control_t control = control_t());
+
         /// Raising a failure causes the failure to be counted and the failure handler to be called.
         /// Further action then depends on its return state.
+        /// Failures raised on other threads or in interrupts are queued and handled by the thread executing the context.
         static void raise_failure(const failure_reason_t reason);
 
-    protected:
-        static void run_next_case();
-        static void handle_timeout();
-        static void schedule_next_case();
+        /// Raises a failure of the test case `source`, which may still overlap with earlier test cases.
+        /// @see set_pipelining
+        static void raise_failure(const Case *const source, const failure_reason_t reason);
+
+        /// @returns the test case whose handler is executing, or `NULL` if no specification is running
+        static const Case *get_current_case();
+
+        /** @returns the metrics of the current test case, or of the last test case once it has been torn down.
+         *
+         * The metrics accumulate over all repeats of the test case, so inside the case teardown handler they
+         * contain the time spent in the setup, handler and callback wait of every repeat so far, but only the
+         * teardowns of earlier repeats.
+         * The complete metrics of every test case are passed to the `case_metrics` handler after its last teardown.
+         */
+        static case_metrics_t get_case_metrics();
     };
 
 }   // namespace v1
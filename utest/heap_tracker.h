@@ -0,0 +1,82 @@
+/****************************************************************************
+ * Copyright (c) 2016, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ****************************************************************************
+ */
+
+#ifndef UTEST_HEAP_TRACKER_H
+#define UTEST_HEAP_TRACKER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "types.h"
+
+#ifndef UTEST_HEAP_TRACKER_AVAILABLE
+    // opt-in, since interposing the allocator conflicts with sanitizers and other allocators, like jemalloc
+#   if defined(YOTTA_CFG_UTEST_HEAP_TRACKER) && defined(__GNUC__) && defined(__GLIBC__) && !defined(__SANITIZE_ADDRESS__)
+#       define UTEST_HEAP_TRACKER_AVAILABLE YOTTA_CFG_UTEST_HEAP_TRACKER
+#   else
+#       define UTEST_HEAP_TRACKER_AVAILABLE 0
+#   endif
+#endif
+
+namespace utest {
+namespace v1 {
+
+    /** Accounting of all heap allocations of the process.
+     *
+     * On glibc hosts `malloc()`, `free()` and their relatives are interposed and forward to the glibc
+     * allocator, so that every allocation of the process is counted, including those of `operator new`.
+     * The sizes are the usable sizes of the blocks, as returned by `malloc_usable_size()`.
+     *
+     * The harness takes a snapshot with `start()` before every phase of a test case and adds the
+     * allocations since then with `stop()`.
+     * Allocations of all threads are counted, so the phases of concurrently running specifications
+     * include the allocations of each other.
+     * Only `get_thread_allocations()` counts the allocations of the calling thread alone.
+     *
+     * @note The tracker is only available on glibc hosts, if enabled with `config.utest.heap_tracker`
+     *       (`UTEST_HEAP_TRACKER_AVAILABLE`), elsewhere nothing is counted.
+     */
+    class HeapTracker
+    {
+    public:
+        /// The counters of the tracker at the start of a phase
+        struct snapshot_t {
+            uint64_t allocations;
+            uint64_t bytes;
+            int64_t live_bytes;
+        };
+
+        /// Takes a snapshot and restarts the peak of the live bytes at the current live bytes.
+        static void start(snapshot_t &snapshot);
+
+        /// Adds the allocations since `start()` to `metrics`.
+        /// @returns the number of allocations since `start()`
+        static uint64_t stop(const snapshot_t &snapshot, heap_metrics_t &metrics);
+
+        /// @returns the number of bytes currently allocated
+        static int64_t get_live_bytes();
+        /// @returns the number of blocks currently allocated
+        static int64_t get_live_blocks();
+        /// @returns the number of allocations of the calling thread so far
+        static uint64_t get_thread_allocations();
+    };
+
+}   // namespace v1
+}   // namespace utest
+
+#endif // UTEST_HEAP_TRACKER_H
@@ -0,0 +1,82 @@
+/****************************************************************************
+ * Copyright (c) 2016, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ****************************************************************************
+ */
+
+#ifndef UTEST_PERF_COUNTERS_H
+#define UTEST_PERF_COUNTERS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "types.h"
+
+#ifndef UTEST_PERF_COUNTERS_AVAILABLE
+#   if defined(__GNUC__) && defined(__linux__)
+#       define UTEST_PERF_COUNTERS_AVAILABLE 1
+#   else
+#       define UTEST_PERF_COUNTERS_AVAILABLE 0
+#   endif
+#endif
+
+namespace utest {
+namespace v1 {
+
+    /** Hardware performance counters of the calling thread, using `perf_event_open()`.
+     *
+     * All counters are opened as one group, so that they are read together with a single system call.
+     * Counters the CPU or the kernel does not provide, for example inside a virtual machine, are left out
+     * and always count zero.
+     * The hardware counters only count in user space, unless `perf_event_paranoid` permits counting in the kernel.
+     *
+     * @note The counters are only available on Linux hosts (`UTEST_PERF_COUNTERS_AVAILABLE`).
+     */
+    class PerfCounters
+    {
+    public:
+        PerfCounters();
+        /// Closes all counters.
+        ~PerfCounters();
+
+        /// Opens the counters of the calling thread, closing previously opened counters.
+        /// @returns `true` if at least one counter could be opened
+        bool open();
+
+        /// Closes all counters.
+        void close();
+
+        /// Remembers the current counts.
+        void start();
+
+        /// Adds the counts since `start()` to `counts`, which is indexed by `perf_counter_t`.
+        void stop(uint64_t *counts);
+
+    private:
+        PerfCounters(const PerfCounters&);
+        PerfCounters &operator=(const PerfCounters&);
+
+        bool read_counts(uint64_t *counts) const;
+
+        int fds[PERF_COUNTER_COUNT];
+        size_t slots[PERF_COUNTER_COUNT];   ///< the position of every open counter in the group
+        size_t count;                       ///< the number of open counters
+        uint64_t started[PERF_COUNTER_COUNT];
+    };
+
+}   // namespace v1
+}   // namespace utest
+
+#endif // UTEST_PERF_COUNTERS_H
@@ -0,0 +1,124 @@
+/****************************************************************************
+ * Copyright (c) 2016, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ****************************************************************************
+ */
+
+#ifndef UTEST_PROCESS_POOL_H
+#define UTEST_PROCESS_POOL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifndef UTEST_PROCESS_POOL_AVAILABLE
+#   if defined(__GNUC__) && (defined(__unix__) || defined(__APPLE__))
+#       define UTEST_PROCESS_POOL_AVAILABLE 1
+#   else
+#       define UTEST_PROCESS_POOL_AVAILABLE 0
+#   endif
+#endif
+
+#ifndef UTEST_PROCESS_POOL_SIZE
+#   ifdef YOTTA_CFG_UTEST_PROCESS_POOL_SIZE
+#       define UTEST_PROCESS_POOL_SIZE YOTTA_CFG_UTEST_PROCESS_POOL_SIZE
+#   else
+#       define UTEST_PROCESS_POOL_SIZE 8
+#   endif
+#endif
+
+namespace utest {
+namespace v1 {
+
+    /** Pool of pre-forked copies of the calling process, each executing exactly one job.
+     *
+     * `prefork()` forks the calling process until the requested number of idle processes exist.
+     * The forked processes block until they receive a job message from `dispatch()` and then return
+     * from the same `prefork()` call, so that they continue executing at its call site with the state of
+     * the parent at the time of the fork.
+     * The job sends a result message back with `report()` and must then terminate the process,
+     * while the parent waits for the result with `wait()`.
+     *
+     * Since every job executes in its own process, a job crashing or hanging cannot affect the parent.
+     *
+     * @note The pool is only available on POSIX hosts (`UTEST_PROCESS_POOL_AVAILABLE`).
+     */
+    class ProcessPool
+    {
+    public:
+        enum status_t {
+            STATUS_OK,          ///< The job reported its result
+            STATUS_CRASHED,     ///< The process terminated without reporting a result
+            STATUS_TIMEOUT,     ///< The job did not report a result in time and its process was killed
+            STATUS_ERROR        ///< No job is executing
+        };
+
+        ProcessPool();
+        /// Terminates all idle processes.
+        ~ProcessPool();
+
+        /** Forks the calling process until `count` idle processes exist.
+         *
+         * @param job   the buffer the job message of a forked process is received into
+         * @param size  the size of the job message
+         *
+         * @retval `true`  in the calling process
+         * @retval `false` in a forked process that received a job message into `job`
+         */
+        bool prefork(size_t count, void *job, const size_t size);
+
+        /// Sends a job message to an idle process.
+        /// @returns `true` if the job was sent, `false` if there is no idle process or another job is executing
+        bool dispatch(const void *job, const size_t size);
+
+        /// Waits for the result of the executing job, a zero `timeout_ms` waits forever.
+        status_t wait(void *result, const size_t size, const uint32_t timeout_ms);
+
+        /// Sends the result message of a job back to the parent and terminates the forked process.
+        /// This function only returns, if it is not called in a forked process.
+        void report(const void *result, const size_t size);
+
+        /// @returns `true` if this is a forked process that received a job
+        bool is_forked() const;
+
+        /// @returns the signal that terminated the process of the last crashed job, or zero
+        int get_signal() const;
+        /// Prints the signal that terminated the process of the last crashed job, if any.
+        void print() const;
+
+        /// Terminates all idle processes.
+        void stop();
+
+    private:
+        ProcessPool(const ProcessPool&);
+        ProcessPool &operator=(const ProcessPool&);
+
+        struct process_t {
+            int pid;
+            int fd;         ///< parent side of the socket pair to the process
+        };
+        void close_process(process_t &process, const bool terminate);
+
+        process_t idle[UTEST_PROCESS_POOL_SIZE];
+        size_t idle_count;
+        process_t executing;
+        int parent_fd;      ///< in a forked process, the socket to the parent
+        int last_signal;
+    };
+
+}   // namespace v1
+}   // namespace utest
+
+#endif // UTEST_PROCESS_POOL_H
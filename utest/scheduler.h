@@ -96,6 +96,95 @@ typedef struct {
     utest_v1_scheduler_run_callback_t run;
 } utest_v1_scheduler_t;
 
+
+/// The version number of the `utest_v1_scheduler_v2_t` interface.
+#define UTEST_V1_SCHEDULER_VERSION_2 2
+
+/**
+ * A callback which receives the context pointer it was posted with.
+ * This allows the scheduler to multiplex callbacks of several harness instances or user callbacks
+ * without requiring a trampoline function per callback.
+ */
+typedef void (*utest_v1_harness_callback_v2_t)(void *context);
+
+/// Opaque handle identifying a posted callback, `NULL` is never a valid handle.
+typedef struct utest_v1_scheduler_handle *utest_v1_scheduler_handle_t;
+
+/**
+ * Schedules a callback with a context pointer and a delay in milliseconds.
+ * The same requirements as for `utest_v1_scheduler_post_callback_t` apply, except that
+ * utest may schedule several callbacks at the same time.
+ *
+ * @param   callback    the pointer to the callback function
+ * @param   context     the pointer passed to the callback function
+ * @param   delay_ms    the delay in milliseconds after which the callback should be executed
+ * @return  A handle to identify the scheduled callback, or `NULL` for failure.
+ */
+typedef utest_v1_scheduler_handle_t (*utest_v1_scheduler_post_v2_callback_t)(const utest_v1_harness_callback_v2_t callback, void *context, const uint32_t delay_ms);
+
+/**
+ * Cancels a callback scheduled with a delay.
+ * Canceling a callback that already executed or was already canceled must have no effect.
+ *
+ * @param   handle  the handle returned from the `post` call to identify which callback to be cancelled.
+ * @retval  `0` if success
+ * @retval  non-zero if failure
+ */
+typedef int32_t (*utest_v1_scheduler_cancel_v2_callback_t)(utest_v1_scheduler_handle_t handle);
+
+/// Describes one callback in a batch post.
+typedef struct {
+    utest_v1_harness_callback_v2_t callback;    ///< the pointer to the callback function
+    void *context;                              ///< the pointer passed to the callback function
+    uint32_t delay_ms;                          ///< the delay in milliseconds
+    utest_v1_scheduler_handle_t handle;         ///< set by the scheduler to the returned handle
+} utest_v1_scheduler_post_t;
+
+/**
+ * Schedules several callbacks at once, which allows the scheduler to lock its queue only once.
+ * Callbacks with the same delay must be executed in the order of the array.
+ *
+ * @param   posts   the array of callbacks, whose `handle` member is set by the scheduler
+ * @param   count   the number of callbacks in the array
+ * @return  The number of callbacks that were scheduled, the scheduler stops at the first failure.
+ */
+typedef size_t (*utest_v1_scheduler_post_batch_callback_t)(utest_v1_scheduler_post_t *const posts, const size_t count);
+
+/**
+ * The version 2 scheduler interface passes a context pointer to its callbacks and returns typed handles.
+ * Set `version` to `UTEST_V1_SCHEDULER_VERSION_2`.
+ * The `post_batch` function is optional and may be `NULL`, all other functions are required.
+ *
+ * You may convert a `utest_v1_scheduler_t` into this interface using `utest_v1_scheduler_adapt()`.
+ */
+typedef struct {
+    uint32_t version;
+    utest_v1_scheduler_init_callback_t init;
+    utest_v1_scheduler_post_v2_callback_t post;
+    utest_v1_scheduler_cancel_v2_callback_t cancel;
+    utest_v1_scheduler_post_batch_callback_t post_batch;
+    utest_v1_scheduler_run_callback_t run;
+} utest_v1_scheduler_v2_t;
+
+#ifndef UTEST_SCHEDULER_ADAPTER_SLOTS
+#   ifdef YOTTA_CFG_UTEST_SCHEDULER_ADAPTER_SLOTS
+#       define UTEST_SCHEDULER_ADAPTER_SLOTS YOTTA_CFG_UTEST_SCHEDULER_ADAPTER_SLOTS
+#   else
+#       define UTEST_SCHEDULER_ADAPTER_SLOTS 8
+#   endif
+#endif
+
+/**
+ * Wraps a `utest_v1_scheduler_t` into the version 2 interface.
+ * Since the wrapped scheduler cannot pass a context, each pending callback occupies one of
+ * `UTEST_SCHEDULER_ADAPTER_SLOTS` internal trampolines, posting fails if all are in use.
+ * Only one scheduler can be adapted at any given time, adapting another one replaces it.
+ */
+utest_v1_scheduler_v2_t utest_v1_scheduler_adapt(const utest_v1_scheduler_t scheduler);
+
+/// Posts the callbacks one by one, for schedulers without a `post_batch` function.
+size_t utest_v1_scheduler_post_each(const utest_v1_scheduler_v2_t *const scheduler, utest_v1_scheduler_post_t *const posts, const size_t count);
+
 #ifdef __cplusplus
 }
 #endif
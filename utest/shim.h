@@ -67,6 +67,14 @@
 #           define UTEST_SHIM_SCHEDULER_USE_US_TICKER 0
 #       endif
 #   endif
+#   ifndef UTEST_SHIM_SCHEDULER_USE_POSIX
+        // opt-in, since host ports may already implement the scheduler and the critical section functions
+#       if defined(YOTTA_CFG_UTEST_POSIX_SCHEDULER) && defined(__linux__) && !UTEST_SHIM_SCHEDULER_USE_MINAR && !UTEST_SHIM_SCHEDULER_USE_US_TICKER
+#           define UTEST_SHIM_SCHEDULER_USE_POSIX YOTTA_CFG_UTEST_POSIX_SCHEDULER
+#       else
+#           define UTEST_SHIM_SCHEDULER_USE_POSIX 0
+#       endif
+#   endif
 #endif  // YOTTA_CFG_UTEST_USE_CUSTOM_SCHEDULER
 
 #ifdef __cplusplus
@@ -77,9 +85,21 @@ extern "C" {
 void utest_v1_enter_critical_section(void);
 void utest_v1_leave_critical_section(void);
 
-/// This is the default scheduler implementation used by the harness.
+/// This is the default scheduler implementation.
 utest_v1_scheduler_t utest_v1_get_scheduler(void);
 
+/// This is the default scheduler implementation used by the harness.
+/// If no scheduler backend is built in, this adapts the `utest_v1_get_scheduler()` of the port.
+utest_v1_scheduler_v2_t utest_v1_get_scheduler_v2(void);
+
+/** @returns a monotonic timestamp in nanoseconds, or `0` if the platform does not provide a clock.
+ *
+ * POSIX hosts use `CLOCK_MONOTONIC_RAW` where available, mbed targets extend the microsecond ticker.
+ * A port may provide a higher resolution clock, like a cycle counter scaled to nanoseconds, by defining
+ * `UTEST_SHIM_GET_TIME_NS()`.
+ */
+uint64_t utest_v1_get_time_ns(void);
+
 #ifdef __cplusplus
 }
 #endif
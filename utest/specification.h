@@ -131,6 +131,7 @@ namespace v1 {
         const handlers_t defaults;
 
         friend class Harness;
+        friend class HarnessContext;
     };
 
 }   // namespace v1
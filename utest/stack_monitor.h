@@ -0,0 +1,115 @@
+/****************************************************************************
+ * Copyright (c) 2016, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ****************************************************************************
+ */
+
+#ifndef UTEST_STACK_MONITOR_H
+#define UTEST_STACK_MONITOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifndef UTEST_ALTERNATE_STACK_AVAILABLE
+#   if defined(__GNUC__) && defined(__linux__) && defined(__GLIBC__)
+#       define UTEST_ALTERNATE_STACK_AVAILABLE 1
+#   else
+#       define UTEST_ALTERNATE_STACK_AVAILABLE 0
+#   endif
+#endif
+
+#ifndef UTEST_STACK_PAINT_MARGIN
+#   ifdef YOTTA_CFG_UTEST_STACK_PAINT_MARGIN
+#       define UTEST_STACK_PAINT_MARGIN YOTTA_CFG_UTEST_STACK_PAINT_MARGIN
+#   else
+#       define UTEST_STACK_PAINT_MARGIN 256
+#   endif
+#endif
+
+namespace utest {
+namespace v1 {
+
+    /** Measures the high-water mark of a stack by painting it.
+     *
+     * The unused part of the stack is filled with a pattern by `paint()` and `get_peak()` finds the
+     * deepest word, which no longer contains the pattern.
+     * While executing on the monitored stack only the part below the caller, minus `UTEST_STACK_PAINT_MARGIN`
+     * bytes for the painting itself and interrupts, is painted.
+     *
+     * The monitor either attaches to an existing stack, like the main stack of a target given by its linker
+     * symbols, or allocates an alternate stack, on which `run()` executes a function.
+     * The alternate stack has an inaccessible guard page below it, so that an overflow faults instead of
+     * corrupting the heap.
+     *
+     * @note Alternate stacks are only available on glibc Linux hosts (`UTEST_ALTERNATE_STACK_AVAILABLE`).
+     */
+    class StackMonitor
+    {
+    public:
+        StackMonitor();
+        /// Releases the alternate stack, unless it is executing.
+        ~StackMonitor();
+
+        /// Monitors the `size` bytes of an existing stack starting at its lowest address `base`.
+        void attach(void *base, const size_t size);
+
+        /// Allocates and monitors an alternate stack of `size` bytes.
+        /// @returns `false` if alternate stacks are not available or the stack could not be allocated
+        bool allocate(const size_t size);
+
+        /// Stops monitoring, releasing an alternate stack.
+        void release();
+
+        /// Executes `function(context)` on the alternate stack and returns once it returns.
+        /// Without an alternate stack, or when already executing on it, the function is called directly.
+        void run(void (*function)(void*), void *context);
+
+        /// @returns `true` if an alternate stack has been allocated
+        bool is_allocated() const { return mapping != NULL; }
+
+        /// @returns `true` if the calling thread executes on the monitored stack
+        bool is_executing() const;
+
+        /// Paints the unused part of the stack.
+        void paint();
+
+        /// @returns the number of bytes that have been used from the top of the stack since it was painted
+        size_t get_peak() const;
+
+    private:
+        StackMonitor(const StackMonitor&);
+        StackMonitor &operator=(const StackMonitor&);
+
+        /// the lowest word, which does not contain the pattern
+        uintptr_t *find_used() const;
+
+        struct contexts_t;
+        static void execute(const uint32_t high, const uint32_t low);
+
+        uintptr_t *bottom;
+        uintptr_t *top;
+        void *mapping;          ///< the alternate stack including its guard page, if allocated
+        size_t mapping_size;
+        contexts_t *contexts;   ///< the contexts switched by `run()`
+        void (*function)(void*);
+        void *context;
+        bool is_painted;
+    };
+
+}   // namespace v1
+}   // namespace utest
+
+#endif // UTEST_STACK_MONITOR_H
@@ -0,0 +1,123 @@
+/****************************************************************************
+ * Copyright (c) 2016, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ****************************************************************************
+ */
+
+#ifndef UTEST_TIMER_QUEUE_H
+#define UTEST_TIMER_QUEUE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include "scheduler.h"
+
+#ifndef UTEST_TIMER_QUEUE_SIZE
+#   ifdef YOTTA_CFG_UTEST_TIMER_QUEUE_SIZE
+#       define UTEST_TIMER_QUEUE_SIZE YOTTA_CFG_UTEST_TIMER_QUEUE_SIZE
+#   else
+#       define UTEST_TIMER_QUEUE_SIZE 8
+#   endif
+#endif
+
+namespace utest {
+namespace v1 {
+
+    /** Queue of pending scheduler callbacks ordered by their timestamp.
+     *
+     * This is a binary min-heap over a fixed number of statically allocated slots, so it
+     * never allocates memory and can be used by scheduler implementations on targets.
+     * Insertion and cancellation are `O(log n)`.
+     *
+     * Timestamps are free-running 32bit counters (ie. microseconds of the `us_ticker`) and
+     * are compared modulo overflow, so all pending timestamps must lie within 2^31 ticks of each other.
+     * Callbacks with the same timestamp are returned in the order they were inserted.
+     *
+     * The returned handles contain a generation counter, so that canceling a handle whose
+     * callback already executed, or whose slot has been reused since, is detected and has no effect.
+     *
+     * @note This class is not thread-safe, you need to lock access to it in your scheduler.
+     */
+    class TimerQueue
+    {
+    public:
+        /// A pending callback of either scheduler interface version.
+        struct callback_t
+        {
+            utest_v1_harness_callback_t callback;
+            utest_v1_harness_callback_v2_t callback_v2;
+            void *context;
+
+            /// executes the callback
+            inline void operator()() const {
+                if (callback_v2) callback_v2(context);
+                else if (callback) callback();
+            }
+        };
+
+        TimerQueue();
+
+        /// Removes all pending callbacks and invalidates all handles.
+        void clear();
+
+        /// @returns a handle to the inserted callback, or `NULL` if the queue is full.
+        void *insert(const utest_v1_harness_callback_t callback, const uint32_t timestamp);
+
+        /// @returns a handle to the inserted callback, or `NULL` if the queue is full.
+        void *insert(const utest_v1_harness_callback_v2_t callback, void *context, const uint32_t timestamp);
+
+        /// @retval `true` if the callback was still pending and has been removed
+        /// @retval `false` if the handle is invalid
+        bool cancel(void *handle);
+
+        /// @returns `true` if no callbacks are pending
+        bool is_empty() const;
+
+        /// @returns the timestamp of the earliest pending callback, must not be called on an empty queue.
+        uint32_t get_next_timestamp() const;
+
+        /// Removes the earliest pending callback, if its timestamp is not later than `now`.
+        /// @returns `true` if a callback expired and was copied into `callback`, `false` otherwise.
+        bool pop_expired(const uint32_t now, callback_t &callback);
+
+    private:
+        struct slot_t
+        {
+            callback_t callback;
+            uint32_t timestamp;
+            uint32_t sequence;
+            uint32_t generation;
+            uint16_t heap_index;
+            uint16_t next_free;
+        };
+
+        void *insert_callback(const callback_t &callback, const uint32_t timestamp);
+        bool is_before(const uint16_t lhs, const uint16_t rhs) const;
+        void swap(const uint16_t lhs, const uint16_t rhs);
+        void sift_up(uint16_t index);
+        void sift_down(uint16_t index);
+        void remove(const uint16_t index);
+
+        slot_t slots[UTEST_TIMER_QUEUE_SIZE];
+        uint16_t heap[UTEST_TIMER_QUEUE_SIZE];
+        uint16_t length;
+        uint16_t free_slot;
+        uint32_t sequence;
+    };
+
+}   // namespace v1
+}   // namespace utest
+
+#endif // UTEST_TIMER_QUEUE_H
@@ -67,6 +67,12 @@ namespace v1 {
 
         REASON_CASE_INDEX    = (1 << 10),   ///< Case index out-of-range
         REASON_SCHEDULER     = (1 << 11),   ///< Asynchronous callback scheduling failed
+        REASON_PERF_REGRESSION = (1 << 12), ///< Benchmark is significantly slower than its baseline
+        REASON_TIMEOUT_HEADROOM = (1 << 13),///< An asynchronous call was validated shortly before its timeout
+        REASON_ALLOCATION    = (1 << 14),   ///< A case handler without allocations allocated heap memory
+        REASON_STACK_BUDGET  = (1 << 16),   ///< The stack used by a test case exceeded its budget
+        REASON_CRASH         = (1 << 17),   ///< The case handler crashed with a signal
+        REASON_NO_CLOCK      = (1 << 18),   ///< A benchmark cannot be measured without a clock
 
         REASON_IGNORE        = 0x8000       ///< The failure may be ignored
     };
@@ -81,6 +87,13 @@ namespace v1 {
         LOCATION_UNKNOWN        ///< A failure occurred in an unknown location
     };
 
+    enum case_attribute_t {
+        CASE_ATTRIBUTE_NONE        = 0,         ///< No special attributes
+        CASE_ATTRIBUTE_INDEPENDENT = (1 << 0),  ///< The case handler shares no state and may run in parallel to other independent cases
+        CASE_ATTRIBUTE_NO_ALLOCATION = (1 << 1), ///< The case handler must not allocate heap memory
+        CASE_ATTRIBUTE_OVERLAPPABLE = (1 << 2)  ///< The case handler only starts an asynchronous operation, whose wait may overlap with other overlappable cases
+    };
+
     /// Contains the reason and location of the failure.
     struct failure_t {
         failure_t() : reason(REASON_NONE), location(LOCATION_NONE) {}
@@ -130,6 +143,7 @@ namespace v1 {
      * - The lower timeout value "wins".
      * - A more involved repeat "wins" (ie. `ALL` > 'HANDLER' > 'NONE').
      * - Next Case always wins.
+     * - The higher number of awaited validations wins.
      *
      * You may then add timeouts and repeats together:
      * @code
@@ -143,16 +157,19 @@ namespace v1 {
      */
     struct control_t
     {
-        control_t() : repeat(REPEAT_UNDECLR), timeout(TIMEOUT_UNDECLR) {}
+        control_t() : repeat(REPEAT_UNDECLR), timeout(TIMEOUT_UNDECLR), await_count(0) {}
 
         control_t(repeat_t repeat, uint32_t timeout_ms) :
-            repeat(repeat), timeout(timeout_ms) {}
+            repeat(repeat), timeout(timeout_ms), await_count(0) {}
+
+        control_t(repeat_t repeat, uint32_t timeout_ms, uint32_t await_count) :
+            repeat(repeat), timeout(timeout_ms), await_count(await_count) {}
 
         control_t(repeat_t repeat) :
-            repeat(repeat), timeout(TIMEOUT_UNDECLR) {}
+            repeat(repeat), timeout(TIMEOUT_UNDECLR), await_count(0) {}
 
         control_t(uint32_t timeout_ms) :
-            repeat(REPEAT_UNDECLR), timeout(timeout_ms) {}
+            repeat(REPEAT_UNDECLR), timeout(timeout_ms), await_count(0) {}
 
         control_t
         inline operator+(const control_t& rhs) const {
@@ -163,6 +180,7 @@ namespace v1 {
             if (result.timeout != TIMEOUT_NONE && result.timeout > rhs.timeout) {
                 result.timeout = rhs.timeout;
             }
+            result.await_count = (this->await_count > rhs.await_count) ? this->await_count : rhs.await_count;
 
             if (result.repeat & REPEAT_NONE) {
                 result.repeat = REPEAT_NONE;
@@ -187,11 +205,18 @@ namespace v1 {
         inline get_timeout() const {
             return timeout;
         }
+        /// @returns the number of validations completing the wait, zero if undeclared, which awaits one validation
+        uint32_t
+        inline get_await_count() const {
+            return await_count;
+        }
 
     private:
         repeat_t repeat;
         uint32_t timeout;
+        uint32_t await_count;
         friend class Harness;
+        friend class HarnessContext;
     };
 
     /// does not repeat this test case and immediately moves on to the next one without timeout
@@ -210,6 +235,9 @@ namespace v1 {
     const  control_t CaseAwait(TIMEOUT_FOREVER);
     /// Alias class for asynchronous timeout control in milliseconds
     inline control_t CaseTimeout(uint32_t ms) { return ms; }
+    /// Alias class for asynchronous timeout control in milliseconds, which
+    /// awaits `count` callback validations instead of one
+    inline control_t CaseAwaitCount(uint32_t count, uint32_t ms) { return control_t(REPEAT_UNDECLR, ms, count); }
 
     /// Alias class for asynchronous timeout control in milliseconds and
     /// repeats the test case handler with calling teardown and setup handlers
@@ -302,6 +330,86 @@ namespace v1 {
      */
     typedef control_t (*case_call_count_handler_t)(const size_t call_count);
 
+    /** Benchmark test case handler
+     *
+     * This handler is called only if the case setup succeeded and must execute the operation to be measured
+     * `iterations` times.
+     * The harness calibrates the number of iterations, so that one call takes `UTEST_BENCHMARK_SAMPLE_US`,
+     * calls the handler for a number of warmup rounds and then measures `UTEST_BENCHMARK_SAMPLES` calls.
+     *
+     * @param   iterations  the number of times the operation must be executed
+     */
+    typedef void (*case_benchmark_handler_t)(const size_t iterations);
+
+    /// The statistics of a benchmark test case, all times are given per iteration
+    struct benchmark_result_t
+    {
+        size_t iterations;      ///< number of iterations per sample
+        size_t samples;         ///< number of samples
+        double min_ns;
+        double median_ns;
+        double p90_ns;
+        double p99_ns;
+        double mean_ns;
+        double stddev_ns;
+        const double *sample_ns;    ///< the time of every sample in ascending order, valid only during the report
+    };
+
+    /// The result of a paired benchmark comparing a candidate handler with a baseline handler
+    struct benchmark_comparison_t
+    {
+        size_t blocks;          ///< number of blocks, each measuring both handlers once in random order
+        double baseline_ns;     ///< median time per iteration of the baseline handler
+        double candidate_ns;    ///< median time per iteration of the candidate handler
+        double ratio;           ///< geometric mean of the candidate to baseline time ratio of all blocks
+        double ratio_low;       ///< lower bound of the 95% confidence interval of the ratio
+        double ratio_high;      ///< upper bound of the 95% confidence interval of the ratio
+    };
+
+    /// The hardware performance counters measured during the case handler
+    enum perf_counter_t {
+        PERF_INSTRUCTIONS,
+        PERF_CYCLES,
+        PERF_CACHE_MISSES,
+        PERF_BRANCH_MISSES,
+        PERF_CONTEXT_SWITCHES,
+
+        PERF_COUNTER_COUNT
+    };
+
+    /// The heap allocations during a phase of a test case
+    struct heap_metrics_t
+    {
+        uint64_t allocations;   ///< number of allocated blocks
+        uint64_t bytes;         ///< number of allocated bytes
+        uint64_t peak_bytes;    ///< largest number of bytes allocated at once, in addition to those allocated before the phase
+    };
+
+    /// The metrics of a test case, accumulated over all of its repeats
+    struct case_metrics_t
+    {
+        uint64_t setup_ns;      ///< time spent in the case setup handler
+        uint64_t handler_ns;    ///< time spent in the case handler
+        uint64_t wait_ns;       ///< time from the return of the case handler until its callback was validated or timed out
+        uint64_t teardown_ns;   ///< time spent in the case teardown handler
+
+        size_t callbacks;               ///< number of awaited callbacks that were validated
+        uint64_t latency_max_ns;        ///< longest time from the return of the case handler until its callback was validated
+        uint32_t timeout_usage_max;     ///< largest part of its timeout a validated callback used, in percent
+        size_t timeout_usage[10];       ///< validated callbacks with a timeout, counted by the part of the timeout they used in steps of 10%
+
+        uint64_t perf_counts[PERF_COUNTER_COUNT];   ///< counted during the case handler, if performance counters are enabled
+
+        heap_metrics_t setup_heap;      ///< allocations of the case setup handler
+        heap_metrics_t handler_heap;    ///< allocations of the case handler
+        heap_metrics_t teardown_heap;   ///< allocations of the case teardown handler
+        int64_t leaked_bytes;           ///< number of bytes allocated during the test case and not freed by its last teardown
+        int64_t leaked_blocks;          ///< number of blocks allocated during the test case and not freed by its last teardown
+
+        size_t stack_peak_bytes;        ///< deepest use of the monitored stack, including the frames of the harness, if a stack is monitored
+        size_t arena_bytes;             ///< number of bytes allocated from the arena, if enabled
+    };
+
     /** Test case teardown handler.
      *
      * This handler is called after execution of each test case or all repeated test cases and
@@ -332,6 +440,35 @@ namespace v1 {
      */
     typedef status_t (*case_failure_handler_t)(const Case *const source, const failure_t reason);
 
+    /** Benchmark report handler.
+     *
+     * This handler is called after a benchmark test case has been measured without failures
+     * and before its test case teardown handler.
+     *
+     * @param   source  the benchmark test case
+     * @param   result  the statistics of the measured samples
+     */
+    typedef void (*case_benchmark_report_handler_t)(const Case *const source, const benchmark_result_t result);
+
+    /** Benchmark comparison report handler.
+     *
+     * This handler is called after all blocks of a paired benchmark test case have been measured without failures
+     * and before its test case teardown handler.
+     *
+     * @param   source      the paired benchmark test case
+     * @param   comparison  the ratio of the candidate to the baseline handler
+     */
+    typedef void (*case_comparison_report_handler_t)(const Case *const source, const benchmark_comparison_t comparison);
+
+    /** Test case metrics report handler.
+     *
+     * This handler is called after the last teardown of every test case, including test cases that aborted the specification.
+     *
+     * @param   source  the test case
+     * @param   metrics the metrics of all repeats of the test case
+     */
+    typedef void (*case_metrics_report_handler_t)(const Case *const source, const case_metrics_t &metrics);
+
 
     // deprecations
     __deprecated_message("Use CaseRepeatAll instead.")     const control_t CaseRepeat            = CaseRepeatAll;
@@ -0,0 +1,74 @@
+/****************************************************************************
+ * Copyright (c) 2016, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ****************************************************************************
+ */
+
+#ifndef UTEST_VIRTUAL_SCHEDULER_H
+#define UTEST_VIRTUAL_SCHEDULER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include "types.h"
+#include "scheduler.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Returns a scheduler with a virtual clock, which executes on top of the `base` scheduler.
+ *
+ * All callbacks posted to this scheduler are ordered by their virtual deadline.
+ * Whenever no callback is due, the virtual clock jumps straight to the earliest pending deadline,
+ * so waiting for a `CaseTimeout(500)` takes no real time at all, while the order of all callbacks
+ * stays exactly the same as with a real clock.
+ * The callbacks are executed one at a time by posting them to the `base` scheduler without delay,
+ * whose `run` function is used as the event loop.
+ *
+ * @warning Asynchronous events that are not posted through this scheduler (ie. real interrupts or
+ *          other schedulers) do not advance the virtual clock and will most likely arrive after
+ *          the timeout has already fired. Post your asynchronous test stimuli to this scheduler instead.
+ *
+ * @param   base    the scheduler executing the callbacks, must support callbacks without delay.
+ */
+utest_v1_scheduler_t utest_v1_get_virtual_scheduler(const utest_v1_scheduler_t base);
+
+/// Returns the virtual time scheduler in the version 2 interface, executing on top of the `base` scheduler.
+/// @note Only one virtual time scheduler exists, so this replaces the base scheduler of `utest_v1_get_virtual_scheduler()`.
+utest_v1_scheduler_v2_t utest_v1_get_virtual_scheduler_v2(const utest_v1_scheduler_v2_t base);
+
+/// @returns the virtual time in microseconds elapsed since the virtual scheduler was initialized.
+uint64_t utest_v1_get_virtual_time_us(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#ifdef __cplusplus
+namespace utest {
+namespace v1 {
+
+    /// Records the virtual and real start time of the case and calls `greentea_case_setup_handler`.
+    status_t virtual_time_case_setup_handler   (const Case *const source, const size_t index_of_case);
+    /// Prints the virtual and real time elapsed since the case setup and calls `greentea_case_teardown_handler`.
+    status_t virtual_time_case_teardown_handler(const Case *const source, const size_t passed, const size_t failed, const failure_t failure);
+
+}   // namespace v1
+}   // namespace utest
+#endif
+
+#endif // UTEST_VIRTUAL_SCHEDULER_H
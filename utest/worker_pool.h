@@ -0,0 +1,98 @@
+/****************************************************************************
+ * Copyright (c) 2016, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ****************************************************************************
+ */
+
+#ifndef UTEST_WORKER_POOL_H
+#define UTEST_WORKER_POOL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifndef UTEST_WORKER_POOL_AVAILABLE
+#   if defined(__GNUC__) && (defined(__unix__) || defined(__APPLE__))
+#       define UTEST_WORKER_POOL_AVAILABLE 1
+#   else
+#       define UTEST_WORKER_POOL_AVAILABLE 0
+#   endif
+#endif
+
+#ifndef UTEST_WORKER_POOL_SIZE
+#   ifdef YOTTA_CFG_UTEST_WORKER_POOL_SIZE
+#       define UTEST_WORKER_POOL_SIZE YOTTA_CFG_UTEST_WORKER_POOL_SIZE
+#   else
+#       define UTEST_WORKER_POOL_SIZE 0
+#   endif
+#endif
+
+namespace utest {
+namespace v1 {
+
+    /** Fixed-size pool of worker threads executing one batch of jobs at a time.
+     *
+     * A batch consists of `count` calls of the same job function with the job index as argument.
+     * The workers claim the jobs in increasing index order, so the caller can consume the results
+     * in order with `wait()` while the later jobs are still executing.
+     *
+     * The pool uses POSIX threads and is only available on hosts (`UTEST_WORKER_POOL_AVAILABLE`).
+     * On all other platforms no worker can be started and `dispatch()` always fails.
+     *
+     * @note Only one thread may dispatch batches and wait for them.
+     */
+    class WorkerPool
+    {
+    public:
+        typedef void (*job_t)(void *context, const size_t index);
+
+        WorkerPool();
+        /// Waits for the current batch and joins all workers.
+        ~WorkerPool();
+
+        /// Starts `count` worker threads, waiting for the current batch first.
+        /// @returns `true` if all workers have been started
+        bool start(const size_t count);
+
+        /// Waits for the current batch and joins all workers.
+        void stop();
+
+        /// @returns the number of running worker threads
+        size_t get_workers() const;
+
+        /// Executes `job(context, index)` for all indices below `count` on the worker threads.
+        /// @returns `true` if the batch was dispatched, `false` if no workers are running or a batch is still executing
+        bool dispatch(const job_t job, void *context, const size_t count);
+
+        /// Blocks until the job with `index` of the current batch finished.
+        void wait(const size_t index);
+
+        /// Blocks until all jobs of the current batch finished and releases the batch.
+        void wait_all();
+
+    private:
+        WorkerPool(const WorkerPool&);
+        WorkerPool &operator=(const WorkerPool&);
+
+        struct state_t;
+        static void *worker_main(void *state);
+
+        state_t *state;
+    };
+
+}   // namespace v1
+}   // namespace utest
+
+#endif // UTEST_WORKER_POOL_H